@@ -21,10 +21,33 @@
 
 #include <exec/single_thread_context.hpp>
 #include <exec/repeat_n.hpp>
+#include <exec/async_scope.hpp>
+#include <exec/task.hpp>
+
+#include <vector>
 
 
 using namespace std::literals;
 
+namespace {
+
+template <template <typename> typename TTask>
+auto Leaf(int i) -> TTask<int> {
+    auto _ = co_await stdexec::get_scheduler();
+    co_return i;
+}
+
+template <template <typename> typename TTask>
+auto Chain(int n) -> TTask<int> {
+    int sum = 0;
+    for (int i = 0; i < n; ++i) {
+        sum += co_await Leaf<TTask>(i);
+    }
+    co_return sum;
+}
+
+}
+
 TEST_CASE("Schedule benchmark", "[loop][bench]") {
     uvexec::loop_t loop;
     exec::single_thread_context thread;
@@ -44,3 +67,180 @@ TEST_CASE("Schedule benchmark", "[loop][bench]") {
         return stdexec::sync_wait(schedule_after0_n).value();
     };
 }
+
+// Exercises the cross-thread wakeup path of Schedule from several producers at once
+TEST_CASE("Multi-producer schedule benchmark", "[loop][bench][mt]") {
+    uvexec::loop_t loop;
+
+    constexpr int n = 1000;
+    auto producersCount = GENERATE(1, 2, 4, 8);
+    std::vector<exec::single_thread_context> producers(producersCount);
+
+    BENCHMARK("Schedule from " + std::to_string(producersCount) + " threads") {
+        exec::async_scope scope;
+        for (auto& producer : producers) {
+            scope.spawn(stdexec::schedule(producer.get_scheduler()) | stdexec::then([&]() noexcept {
+                for (int i = 0; i < n; ++i) {
+                    scope.spawn(stdexec::schedule(loop.get_scheduler()));
+                }
+            }));
+        }
+        return stdexec::sync_wait(stdexec::schedule(loop.get_scheduler()) | stdexec::let_value([&]() noexcept {
+            return scope.on_empty();
+        })).value();
+    };
+
+    BENCHMARK("Batched schedule from " + std::to_string(producersCount) + " threads") {
+        exec::async_scope scope;
+        for (auto& producer : producers) {
+            scope.spawn(stdexec::schedule(producer.get_scheduler()) | stdexec::then([&]() noexcept {
+                uvexec::loop_t::TScheduleBatch batch(loop);
+                for (int i = 0; i < n; ++i) {
+                    scope.spawn(stdexec::schedule(loop.get_scheduler()), batch.get_env());
+                }
+            }));
+        }
+        return stdexec::sync_wait(stdexec::schedule(loop.get_scheduler()) | stdexec::let_value([&]() noexcept {
+            return scope.on_empty();
+        })).value();
+    };
+}
+
+TEST_CASE("Pinned pool benchmark", "[pool][bench][mt]") {
+    constexpr int n = 100;
+
+    auto pinned = GENERATE(false, true);
+    uvexec::loop_pool_options_t options;
+    if (pinned) {
+        for (std::size_t cpu = 0; cpu < options.Size; ++cpu) {
+            options.Affinity.push_back({cpu});
+        }
+    }
+    uvexec::loop_pool_t pool(options);
+
+    BENCHMARK(std::string(pinned ? "Pinned" : "Floating") + " pool hops") {
+        exec::async_scope scope;
+        for (std::size_t i = 0; i < pool.size(); ++i) {
+            scope.spawn(stdexec::schedule(pool.get_scheduler(i))
+                    | stdexec::transfer(pool.get_scheduler((i + 1) % pool.size()))
+                    | exec::repeat_n(n));
+        }
+        return stdexec::sync_wait(scope.on_empty()).value();
+    };
+}
+
+TEST_CASE("Loop to loop benchmark", "[pool][bench][mt]") {
+    constexpr int n = 1000;
+
+    uvexec::loop_pool_t pool(2);
+
+    // All hops are made by the first loop during one phase, so the second one is woken up once
+    BENCHMARK("Fan-out of " + std::to_string(n) + " hops") {
+        exec::async_scope scope;
+        return stdexec::sync_wait(stdexec::schedule(pool.get_scheduler(0)) | stdexec::then([&]() noexcept {
+            for (int i = 0; i < n; ++i) {
+                scope.spawn(stdexec::schedule(pool.get_scheduler(0)) | stdexec::transfer(pool.get_scheduler(1)));
+            }
+        }) | stdexec::let_value([&]() noexcept {
+            return scope.on_empty();
+        })).value();
+    };
+}
+
+TEST_CASE("Coroutine benchmark", "[loop][bench][coro]") {
+    uvexec::loop_t loop;
+
+    constexpr int n = 100;
+
+    BENCHMARK("exec::task chain") {
+        return stdexec::sync_wait(stdexec::schedule(loop.get_scheduler()) | stdexec::let_value([] {
+            return Chain<exec::task>(n);
+        })).value();
+    };
+    BENCHMARK("uvexec::task chain") {
+        return stdexec::sync_wait(stdexec::schedule(loop.get_scheduler()) | stdexec::let_value([] {
+            return Chain<uvexec::task>(n);
+        })).value();
+    };
+}
+
+TEST_CASE("Spawn allocation benchmark", "[loop][bench]") {
+    uvexec::loop_t loop;
+
+    constexpr int n = 1000;
+
+    BENCHMARK("Spawn " + std::to_string(n) + " with the default allocator") {
+        exec::async_scope scope;
+        return stdexec::sync_wait(stdexec::schedule(loop.get_scheduler()) | stdexec::let_value([&]() noexcept {
+            for (int i = 0; i < n; ++i) {
+                scope.spawn(stdexec::schedule(loop.get_scheduler()));
+            }
+            return scope.on_empty();
+        })).value();
+    };
+    BENCHMARK("Spawn " + std::to_string(n) + " with the loop allocator") {
+        exec::async_scope scope;
+        return stdexec::sync_wait(stdexec::schedule(loop.get_scheduler()) | stdexec::let_value([&]() noexcept {
+            for (int i = 0; i < n; ++i) {
+                uvexec::spawn(scope, stdexec::schedule(loop.get_scheduler()), uvexec::scheduler_t::TLoopEnv(loop));
+            }
+            return scope.on_empty();
+        })).value();
+    };
+}
+
+TEST_CASE("Timers benchmark", "[loop][bench][timer]") {
+    uvexec::loop_t loop;
+
+    constexpr int n = 10'000;
+
+    BENCHMARK("Start and cancel " + std::to_string(n) + " timers") {
+        exec::async_scope scope;
+        return stdexec::sync_wait(stdexec::schedule(loop.get_scheduler()) | stdexec::let_value([&]() noexcept {
+            for (int i = 0; i < n; ++i) {
+                scope.spawn(exec::schedule_after(loop.get_scheduler(), std::chrono::milliseconds(1000 + i)));
+            }
+            scope.request_stop();
+            return scope.on_empty();
+        })).value();
+    };
+    BENCHMARK("Expire " + std::to_string(n) + " timers") {
+        exec::async_scope scope;
+        return stdexec::sync_wait(stdexec::schedule(loop.get_scheduler()) | stdexec::let_value([&]() noexcept {
+            for (int i = 0; i < n; ++i) {
+                scope.spawn(exec::schedule_after(loop.get_scheduler(), std::chrono::milliseconds(i % 4)));
+            }
+            return scope.on_empty();
+        })).value();
+    };
+    BENCHMARK("Sleep 100us") {
+        return stdexec::sync_wait(exec::schedule_after(loop.get_scheduler(), 100us)).value();
+    };
+    BENCHMARK("Tick 10 times every 100us") {
+        return stdexec::sync_wait(uvexec::every(stdexec::schedule(loop.get_scheduler()), 100us,
+                [ticks = std::size_t{0}](std::size_t elapsed) mutable noexcept {
+                    return (ticks += elapsed) < 10;
+                })).value();
+    };
+    BENCHMARK("Schedule with 1s timeout") {
+        return stdexec::sync_wait(uvexec::with_timeout(stdexec::schedule(loop.get_scheduler()), 1s)).value();
+    };
+}
+
+TEST_CASE("Timer slack benchmark", "[loop][bench][timer]") {
+    uvexec::loop_t loop;
+
+    constexpr int n = 1000;
+
+    auto slack = GENERATE(0ms, 8ms);
+    BENCHMARK("Expire " + std::to_string(n) + " timers with " + std::to_string(slack.count()) + "ms slack") {
+        exec::async_scope scope;
+        return stdexec::sync_wait(stdexec::schedule(loop.get_scheduler()) | stdexec::let_value([&]() noexcept {
+            for (int i = 0; i < n; ++i) {
+                auto timeout = std::chrono::milliseconds(i % 16);
+                scope.spawn(uvexec::after(stdexec::schedule(loop.get_scheduler()), timeout, slack));
+            }
+            return scope.on_empty();
+        })).value();
+    };
+}
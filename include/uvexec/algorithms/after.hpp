@@ -26,14 +26,17 @@ public:
     using sender_concept = stdexec::sender_t;
     using completion_signatures = TScheduleEventuallyCompletionSignatures;
 
-    explicit TAfterScheduleSender(TLoop& loop, std::chrono::milliseconds timeout) noexcept
-        : Timeout(std::max(timeout, std::chrono::milliseconds{0})), Loop{&loop}
+    explicit TAfterScheduleSender(TLoop& loop, TLoopClock::duration timeout,
+            TLoopClock::duration slack = TLoopClock::duration{0}) noexcept
+        : Timeout(std::max(timeout, TLoopClock::duration{0}))
+        , Slack(std::max(slack, TLoopClock::duration{0}))
+        , Loop{&loop}
     {}
 
     template <stdexec::receiver_of<completion_signatures> TReceiver>
     friend auto tag_invoke(stdexec::connect_t, TAfterScheduleSender s, TReceiver&& rec) {
         return TAfterScheduleOpState<std::decay_t<TReceiver>, Type>(
-                *s.Loop, static_cast<std::uint64_t>(s.Timeout.count()), std::forward<TReceiver>(rec));
+                *s.Loop, s.Timeout, s.Slack, std::forward<TReceiver>(rec));
     }
 
     friend auto tag_invoke(stdexec::get_env_t, const TAfterScheduleSender& s) noexcept {
@@ -41,7 +44,8 @@ public:
     }
 
 private:
-    std::chrono::milliseconds Timeout;
+    TLoopClock::duration Timeout;
+    TLoopClock::duration Slack;
     TLoop* Loop;
 };
 
@@ -51,14 +55,18 @@ public:
     using sender_concept = stdexec::sender_t;
 
 public:
-    TAfterSender(TSender sender, TLoop& loop, std::chrono::milliseconds timeout)
-        : Sender(std::move(sender)), Loop{&loop}, Timeout(std::max(timeout, std::chrono::milliseconds{0}))
+    TAfterSender(TSender sender, TLoop& loop, TLoopClock::duration timeout,
+            TLoopClock::duration slack = TLoopClock::duration{0})
+        : Sender(std::move(sender))
+        , Loop{&loop}
+        , Timeout(std::max(timeout, TLoopClock::duration{0}))
+        , Slack(std::max(slack, TLoopClock::duration{0}))
     {}
 
     template <stdexec::receiver TReceiver>
     friend auto tag_invoke(stdexec::connect_t, TAfterSender s, TReceiver&& rec) {
-        return TAfterOpState<TSender, std::decay_t<TReceiver>, Type>(*s.Loop,
-                static_cast<std::uint64_t>(s.Timeout.count()), std::move(s.Sender), std::forward<TReceiver>(rec));
+        return TAfterOpState<TSender, std::decay_t<TReceiver>, Type>(
+                *s.Loop, s.Timeout, s.Slack, std::move(s.Sender), std::forward<TReceiver>(rec));
     }
 
     friend auto tag_invoke(stdexec::get_env_t, const TAfterSender& s) noexcept {
@@ -74,7 +82,8 @@ public:
 private:
     TSender Sender;
     TLoop* Loop;
-    std::chrono::milliseconds Timeout;
+    TLoopClock::duration Timeout;
+    TLoopClock::duration Slack;
 };
 
 template<ETimerType Type>
@@ -84,23 +93,27 @@ public:
     using sender_concept = stdexec::sender_t;
 
 public:
-    TAfterSender(TJustSender<> sender, TLoop& loop, std::chrono::milliseconds timeout)
-        : Sender(std::move(sender)), Loop{&loop}, Timeout(std::max(timeout, std::chrono::milliseconds{0}))
+    TAfterSender(TJustSender<> sender, TLoop& loop, TLoopClock::duration timeout,
+            TLoopClock::duration slack = TLoopClock::duration{0})
+        : Sender(std::move(sender))
+        , Loop{&loop}
+        , Timeout(std::max(timeout, TLoopClock::duration{0}))
+        , Slack(std::max(slack, TLoopClock::duration{0}))
     {}
 
     template <stdexec::sender TSender>
     auto operator()(TSender&& sender) const {
         if constexpr (Type == ETimerType::At) {
-            return uvexec::at(std::forward<TSender>(sender), *Loop, Timeout);
+            return uvexec::at(std::forward<TSender>(sender), TLoopClock::time_point(Timeout), Slack);
         } else {
-            return uvexec::after(std::forward<TSender>(sender), *Loop, Timeout);
+            return uvexec::after(std::forward<TSender>(sender), Timeout, Slack);
         }
     }
 
     template <stdexec::receiver TReceiver>
     friend auto tag_invoke(stdexec::connect_t, TAfterSender s, TReceiver&& rec) {
-        return TAfterOpState<TJustSender<>, std::decay_t<TReceiver>, Type>(*s.Loop,
-                static_cast<std::uint64_t>(s.Timeout.count()), std::move(s.Sender), std::forward<TReceiver>(rec));
+        return TAfterOpState<TJustSender<>, std::decay_t<TReceiver>, Type>(
+                *s.Loop, s.Timeout, s.Slack, std::move(s.Sender), std::forward<TReceiver>(rec));
     }
 
     friend auto tag_invoke(stdexec::get_env_t, const TAfterSender& s) noexcept {
@@ -116,7 +129,8 @@ public:
 private:
     [[no_unique_address]] TJustSender<> Sender;
     TLoop* Loop;
-    std::chrono::milliseconds Timeout;
+    TLoopClock::duration Timeout;
+    TLoopClock::duration Slack;
 };
 
 template <typename TAdapterClosure, ETimerType Type> requires std::derived_from<
@@ -125,50 +139,66 @@ auto operator|(TAfterSender<TJustSender<>, Type> sender, TAdapterClosure&& closu
     return std::forward<TAdapterClosure>(closure)(std::move(sender));
 }
 
-template <stdexec::sender TSender, typename TRep, typename TPeriod> requires
+// Slack is the optional second element of the package data, see uvexec::after
+template <typename... TSlack>
+auto TimerSlack(const std::tuple<TSlack...>& data) noexcept -> TLoopClock::duration {
+    if constexpr (sizeof...(TSlack) > 1) {
+        return std::chrono::ceil<TLoopClock::duration>(std::get<1>(data));
+    } else {
+        return TLoopClock::duration{0};
+    }
+}
+
+template <stdexec::sender TSender, typename TRep, typename TPeriod, typename... TSlack> requires
+        (sizeof...(TSlack) <= 1) &&
         std::same_as<TLoop::TScheduler, std::invoke_result_t<
                 stdexec::get_completion_scheduler_t<stdexec::set_value_t>, stdexec::env_of_t<TSender>>> &&
-        std::convertible_to<std::chrono::duration<TRep, TPeriod>, std::chrono::milliseconds>
+        std::convertible_to<std::chrono::duration<TRep, TPeriod>, TLoopClock::duration>
 auto tag_invoke(TLoop::TDomain d,
-        TSenderPackage<uvexec::after_t, TSender, std::tuple<std::chrono::duration<TRep, TPeriod>>> s)
+        TSenderPackage<uvexec::after_t, TSender, std::tuple<std::chrono::duration<TRep, TPeriod>, TSlack...>> s)
         noexcept(std::is_nothrow_constructible_v<std::decay_t<TSender>, TSender>) {
     auto sch = stdexec::get_completion_scheduler<stdexec::set_value_t>(stdexec::get_env(s));
     return TAfterSender<std::decay_t<TSender>, ETimerType::After>(
-            std::move(s.Sender), d.GetLoop(sch), std::get<0>(s.Data));
+            std::move(s.Sender), d.GetLoop(sch), std::get<0>(s.Data), TimerSlack(s.Data));
 }
 
-template <stdexec::sender TSender, typename TEnv, typename TRep, typename TPeriod> requires
+template <stdexec::sender TSender, typename TEnv, typename TRep, typename TPeriod, typename... TSlack> requires
+        (sizeof...(TSlack) <= 1) &&
         std::same_as<TLoop::TScheduler, std::invoke_result_t<stdexec::get_scheduler_t, const TEnv&>> &&
-        std::convertible_to<std::chrono::duration<TRep, TPeriod>, std::chrono::milliseconds>
+        std::convertible_to<std::chrono::duration<TRep, TPeriod>, TLoopClock::duration>
 auto tag_invoke(TLoop::TDomain d,
-        TSenderPackage<uvexec::after_t, TSender, std::tuple<std::chrono::duration<TRep, TPeriod>>> s,
+        TSenderPackage<uvexec::after_t, TSender, std::tuple<std::chrono::duration<TRep, TPeriod>, TSlack...>> s,
         const TEnv& e) noexcept(std::is_nothrow_constructible_v<std::decay_t<TSender>, TSender>) {
     auto sch = stdexec::get_scheduler(e);
     return TAfterSender<std::decay_t<TSender>, ETimerType::After>(
-            std::move(s.Sender), d.GetLoop(sch), std::get<0>(s.Data));
+            std::move(s.Sender), d.GetLoop(sch), std::get<0>(s.Data), TimerSlack(s.Data));
 }
 
-template <stdexec::sender TSender, typename TDuration> requires
+template <stdexec::sender TSender, typename TDuration, typename... TSlack> requires
+        (sizeof...(TSlack) <= 1) &&
         std::same_as<TLoop::TScheduler, std::invoke_result_t<
                 stdexec::get_completion_scheduler_t<stdexec::set_value_t>, stdexec::env_of_t<TSender>>> &&
-        std::convertible_to<TDuration, std::chrono::milliseconds>
+        std::convertible_to<TDuration, TLoopClock::duration>
 auto tag_invoke(TLoop::TDomain d,
-        TSenderPackage<uvexec::at_t, TSender, std::tuple<std::chrono::time_point<TLoopClock, TDuration>>> s)
+        TSenderPackage<uvexec::at_t, TSender,
+                std::tuple<std::chrono::time_point<TLoopClock, TDuration>, TSlack...>> s)
         noexcept(std::is_nothrow_constructible_v<std::decay_t<TSender>, TSender>) {
     auto sch = stdexec::get_completion_scheduler<stdexec::set_value_t>(stdexec::get_env(s));
     return TAfterSender<std::decay_t<TSender>, ETimerType::At>(
-            std::move(s.Sender), d.GetLoop(sch), std::get<0>(s.Data).time_since_epoch());
+            std::move(s.Sender), d.GetLoop(sch), std::get<0>(s.Data).time_since_epoch(), TimerSlack(s.Data));
 }
 
-template <stdexec::sender TSender, typename TEnv, typename TDuration> requires
+template <stdexec::sender TSender, typename TEnv, typename TDuration, typename... TSlack> requires
+        (sizeof...(TSlack) <= 1) &&
         std::same_as<TLoop::TScheduler, std::invoke_result_t<stdexec::get_scheduler_t, const TEnv&>> &&
-        std::convertible_to<TDuration, std::chrono::milliseconds>
+        std::convertible_to<TDuration, TLoopClock::duration>
 auto tag_invoke(TLoop::TDomain d,
-        TSenderPackage<uvexec::at_t, TSender, std::tuple<std::chrono::time_point<TLoopClock, TDuration>>> s,
+        TSenderPackage<uvexec::at_t, TSender,
+                std::tuple<std::chrono::time_point<TLoopClock, TDuration>, TSlack...>> s,
         const TEnv& e) noexcept(std::is_nothrow_constructible_v<std::decay_t<TSender>, TSender>) {
     auto sch = stdexec::get_scheduler(e);
     return TAfterSender<std::decay_t<TSender>, ETimerType::At>(
-            std::move(s.Sender), d.GetLoop(sch), std::get<0>(s.Data).time_since_epoch());
+            std::move(s.Sender), d.GetLoop(sch), std::get<0>(s.Data).time_since_epoch(), TimerSlack(s.Data));
 }
 
 inline auto tag_invoke(exec::schedule_after_t,
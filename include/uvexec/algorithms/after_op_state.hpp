@@ -26,14 +26,27 @@ enum class ETimerType {
     At
 };
 
+template <ETimerType Type>
+inline constexpr const char* TimerName = Type == ETimerType::At ? "at" : "after";
+
+template <ETimerType Type>
+auto TimerDeadline(TLoopClock::duration timeout) noexcept -> TLoopClock::time_point {
+    if constexpr (Type == ETimerType::At) {
+        return TLoopClock::time_point(timeout);
+    } else {
+        return TLoopClock::now() + timeout;
+    }
+}
+
 template <stdexec::receiver_of<TScheduleEventuallyCompletionSignatures> TReceiver, ETimerType Type>
-class TAfterScheduleOpState final : public TLoop::TOperation {
+class TAfterScheduleOpState final : public TLoop::TOperation, public TLoop::TTimer {
 public:
-    TAfterScheduleOpState(TLoop& loop, std::uint64_t timeout, TReceiver&& receiver)
+    TAfterScheduleOpState(TLoop& loop, TLoopClock::duration timeout, TLoopClock::duration slack, TReceiver&& receiver)
         : StopOp(StopCallback, *this, loop, stdexec::get_stop_token(stdexec::get_env(receiver)))
         , Loop{&loop}
         , Receiver(std::move(receiver))
         , Timeout{timeout}
+        , Slack{slack}
     {}
 
     friend void tag_invoke(stdexec::start_t, TAfterScheduleOpState& op) noexcept {
@@ -41,61 +54,38 @@ public:
     }
 
     void Apply() noexcept override {
-        auto err = NUvUtil::Init(Timer, NUvUtil::RawUvObject(*Loop));
-        if (NUvUtil::IsError(err)) {
-            stdexec::set_error(std::move(Receiver), EErrc{err});
-        }
-        Timer.data = this;
-        std::uint64_t timeout;
-        if constexpr (Type == ETimerType::At) {
-            auto now = NUvUtil::Now(*Timer.loop);
-            timeout = now > Timeout ? 0 : Timeout - now;
-        } else {
-            timeout = Timeout;
-        }
-
-        err = NUvUtil::TimerStart(Timer, AfterCallback, timeout, 0);
-        if (NUvUtil::IsError(err)) {
-            stdexec::set_error(std::move(Receiver), EErrc{err});
-        } else {
-            StopOp.Setup();
-        }
+        Trace.Begin(NUvUtil::RawUvObject(*Loop), TimerName<Type>);
+        StopOp.Setup();
+        Loop->StartTimer(*this, TimerDeadline<Type>(Timeout), Slack);
     }
 
-private:
-    static void AfterCallback(uv_timer_t* timer) {
-        auto opState = static_cast<TAfterScheduleOpState*>(timer->data);
-        if (!opState->StopOp.Reset()) {
-            NUvUtil::Close(*timer, CloseCallback);
-        }
-    }
-
-    static void CloseCallback(uv_handle_t* timer) {
-        auto opState = NUvUtil::GetData<TAfterScheduleOpState>(timer);
-        if (!opState->StopOp.ResetUnsafe()) {
-            stdexec::set_stopped(std::move(opState->Receiver));
-        } else {
-            stdexec::set_value(std::move(opState->Receiver));
+    void Fire() noexcept override {
+        if (!StopOp.Reset()) {
+            Trace.End();
+            stdexec::set_value(std::move(Receiver));
         }
     }
 
+private:
     static void StopCallback(TAfterScheduleOpState& op) noexcept {
-        NUvUtil::TimerStop(op.Timer);
-        NUvUtil::Close(op.Timer, CloseCallback);
+        op.Loop->StopTimer(op);
+        op.Trace.End();
+        stdexec::set_stopped(std::move(op.Receiver));
     }
 
     using TStopToken = stdexec::stop_token_of_t<stdexec::env_of_t<TReceiver>>;
 
 private:
     TLoop::TStopOperation<TAfterScheduleOpState, TStopToken> StopOp;
-    uv_timer_t Timer;
     TLoop* Loop;
     TReceiver Receiver;
-    std::uint64_t Timeout;
+    TLoopClock::duration Timeout;
+    TLoopClock::duration Slack;
+    [[no_unique_address]] TTraceSpan Trace;
 };
 
 template <stdexec::sender TSender, stdexec::receiver TReceiver, ETimerType Type>
-class TAfterOpState {
+class TAfterOpState final : public TLoop::TTimer {
     class TAfterReceiver final : public stdexec::receiver_adaptor<TAfterReceiver, TReceiver> {
         friend stdexec::receiver_adaptor<TAfterReceiver, TReceiver>;
 
@@ -105,25 +95,10 @@ class TAfterOpState {
         {}
 
         void set_value() noexcept {
-            auto err = NUvUtil::Init(Op->Timer, NUvUtil::RawUvObject(*Op->Loop));
-            if (NUvUtil::IsError(err)) {
-                stdexec::set_error(std::move(*this).base(), EErrc{err});
-            }
-            Op->Timer.data = Op;
-            std::uint64_t timeout;
-            if constexpr (Type == ETimerType::At) {
-                auto now = NUvUtil::Now(*Op->Timer.loop);
-                timeout = now > Op->Timeout ? 0 : Op->Timeout - now;
-            } else {
-                timeout = Op->Timeout;
-            }
-            err = NUvUtil::TimerStart(Op->Timer, AfterCallback, timeout, 0);
-            if (NUvUtil::IsError(err)) {
-                stdexec::set_error(std::move(*this).base(), EErrc{err});
-            } else {
-                Op->Receiver.emplace(std::move(*this).base());
-                Op->StopOp.Setup();
-            }
+            Op->Receiver.emplace(std::move(*this).base());
+            Op->Trace.Begin(NUvUtil::RawUvObject(*Op->Loop), TimerName<Type>);
+            Op->StopOp.Setup();
+            Op->Loop->StartTimer(*Op, TimerDeadline<Type>(Op->Timeout), Op->Slack);
         }
 
     private:
@@ -133,37 +108,30 @@ class TAfterOpState {
     using TOpState = stdexec::connect_result_t<TSender, TAfterReceiver>;
 
 public:
-    TAfterOpState(TLoop& loop, std::uint64_t timeout, TSender&& sender, TReceiver&& receiver)
+    TAfterOpState(TLoop& loop, TLoopClock::duration timeout, TLoopClock::duration slack, TSender&& sender, TReceiver&& receiver)
         : StopOp(StopCallback, *this, loop, stdexec::get_stop_token(stdexec::get_env(receiver)))
         , Op(stdexec::connect(std::move(sender), TAfterReceiver(*this, std::move(receiver))))
         , Loop{&loop}
         , Timeout{timeout}
+        , Slack{slack}
     {}
 
     friend void tag_invoke(stdexec::start_t, TAfterOpState& op) noexcept {
         stdexec::start(op.Op);
     }
 
-private:
-    static void AfterCallback(uv_timer_t* timer) {
-        auto opState = static_cast<TAfterOpState*>(timer->data);
-        if (!opState->StopOp.Reset()) {
-            NUvUtil::Close(*timer, CloseCallback);
-        }
-    }
-
-    static void CloseCallback(uv_handle_t* signal) {
-        auto opState = NUvUtil::GetData<TAfterOpState>(signal);
-        if (!opState->StopOp.ResetUnsafe()) {
-            stdexec::set_stopped(*std::move(opState->Receiver));
-        } else {
-            stdexec::set_value(*std::move(opState->Receiver));
+    void Fire() noexcept override {
+        if (!StopOp.Reset()) {
+            Trace.End();
+            stdexec::set_value(*std::move(Receiver));
         }
     }
 
+private:
     static void StopCallback(TAfterOpState& op) noexcept {
-        NUvUtil::TimerStop(op.Timer);
-        NUvUtil::Close(op.Timer, CloseCallback);
+        op.Loop->StopTimer(op);
+        op.Trace.End();
+        stdexec::set_stopped(*std::move(op.Receiver));
     }
 
     using TStopToken = stdexec::stop_token_of_t<stdexec::env_of_t<TReceiver>>;
@@ -171,10 +139,11 @@ private:
 private:
     TLoop::TStopOperation<TAfterOpState, TStopToken> StopOp;
     TOpState Op;
-    uv_timer_t Timer;
     TLoop* Loop;
     std::optional<TReceiver> Receiver;
-    std::uint64_t Timeout;
+    TLoopClock::duration Timeout;
+    TLoopClock::duration Slack;
+    [[no_unique_address]] TTraceSpan Trace;
 };
 
 }
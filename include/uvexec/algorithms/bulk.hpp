@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2024 Michael Guzov
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "bulk_op_state.hpp"
+
+
+namespace NUvExec {
+
+template <stdexec::sender TSender, std::integral TShape, typename TFun>
+class TBulkSender {
+public:
+    using sender_concept = stdexec::sender_t;
+
+public:
+    TBulkSender(TSender sender, TLoop& loop, TShape shape, TFun fun)
+        : Sender(std::move(sender)), Loop{&loop}, Shape{shape}, Fun(std::move(fun))
+    {}
+
+    template <stdexec::receiver TReceiver>
+    friend auto tag_invoke(stdexec::connect_t, TBulkSender s, TReceiver&& rec) {
+        return TBulkOpState<TSender, std::decay_t<TReceiver>, TShape, TFun>(
+                *s.Loop, s.Shape, std::move(s.Fun), std::move(s.Sender), std::forward<TReceiver>(rec));
+    }
+
+    friend auto tag_invoke(stdexec::get_env_t, const TBulkSender& s) noexcept {
+        return stdexec::get_env(s.Sender);
+    }
+
+    template <typename TEnv>
+    friend auto tag_invoke(stdexec::get_completion_signatures_t, const TBulkSender&, const TEnv&) noexcept {
+        return stdexec::make_completion_signatures<TSender, TEnv, TExceptionCompletionSignatures>{};
+    }
+
+private:
+    TSender Sender;
+    TLoop* Loop;
+    TShape Shape;
+    TFun Fun;
+};
+
+// Iterations are spread over TLoopOptions::BulkPool, the completion is delivered back on the original loop
+template <stdexec::sender_expr_for<stdexec::bulk_t> TSender> requires
+        std::same_as<TLoop::TScheduler, std::invoke_result_t<
+                stdexec::get_completion_scheduler_t<stdexec::set_value_t>, stdexec::env_of_t<TSender>>>
+auto tag_invoke(TLoop::TDomain d, TSender&& s) {
+    auto sch = stdexec::get_completion_scheduler<stdexec::set_value_t>(stdexec::get_env(s));
+    auto& loop = d.GetLoop(sch);
+    return stdexec::__sexpr_apply(std::forward<TSender>(s), [&]<typename TData, typename TChild>(
+            stdexec::__ignore, TData&& data, TChild&& child) {
+        using TShape = decltype(data.__shape_);
+        using TFun = std::decay_t<decltype(data.__fun_)>;
+        return TBulkSender<std::decay_t<TChild>, TShape, TFun>(
+                std::forward<TChild>(child), loop, data.__shape_, std::forward<TData>(data).__fun_);
+    });
+}
+
+}
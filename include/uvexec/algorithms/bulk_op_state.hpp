@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2024 Michael Guzov
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "completion_signatures.hpp"
+#include <uvexec/execution/loop.hpp>
+#include <uvexec/execution/loop_pool.hpp>
+
+#include <exception>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <variant>
+
+
+namespace NUvExec {
+
+template <stdexec::sender TSender, stdexec::receiver TReceiver, std::integral TShape, typename TFun>
+class TBulkOpState {
+    using TValues = stdexec::value_types_of_t<TSender, stdexec::env_of_t<TReceiver>,
+            NDetail::TDecayedTuple, NDetail::TNullableVariant>;
+
+    class TBulkReceiver final : public stdexec::receiver_adaptor<TBulkReceiver, TReceiver> {
+        friend stdexec::receiver_adaptor<TBulkReceiver, TReceiver>;
+
+    public:
+        TBulkReceiver(TBulkOpState& op, TReceiver&& rec) noexcept
+            : stdexec::receiver_adaptor<TBulkReceiver, TReceiver>(std::move(rec)), Op{&op}
+        {}
+
+        template <typename... TArgs>
+        void set_value(TArgs&&... args) noexcept {
+            try {
+                Op->Values.template emplace<NDetail::TDecayedTuple<TArgs...>>(std::forward<TArgs>(args)...);
+            } catch (...) {
+                stdexec::set_error(std::move(*this).base(), std::current_exception());
+                return;
+            }
+            Op->Receiver.emplace(std::move(*this).base());
+            Op->FanOut();
+        }
+
+    private:
+        TBulkOpState* Op;
+    };
+
+    // Contiguous range of iterations run by one of the pool loops
+    class TChunk final : public TLoop::TOperation {
+    public:
+        void Apply() noexcept override {
+            Op->Run(Begin, End);
+            if (Op->Pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                Op->Loop->Schedule(Op->Completion);
+            }
+        }
+
+        TBulkOpState* Op{nullptr};
+        TShape Begin{};
+        TShape End{};
+    };
+
+    class TCompletion final : public TLoop::TOperation {
+    public:
+        explicit TCompletion(TBulkOpState& op) noexcept
+            : Op{&op}
+        {}
+
+        void Apply() noexcept override {
+            Op->Complete();
+        }
+
+    private:
+        TBulkOpState* Op;
+    };
+
+    using TOpState = stdexec::connect_result_t<TSender, TBulkReceiver>;
+
+public:
+    TBulkOpState(TLoop& loop, TShape shape, TFun&& fun, TSender&& sender, TReceiver&& receiver)
+        : Op(stdexec::connect(std::move(sender), TBulkReceiver(*this, std::move(receiver))))
+        , Completion(*this)
+        , Loop{&loop}
+        , Shape{shape}
+        , Fun(std::move(fun))
+        , Pending{0}
+    {}
+
+    friend void tag_invoke(stdexec::start_t, TBulkOpState& op) noexcept {
+        stdexec::start(op.Op);
+    }
+
+private:
+    void FanOut() noexcept {
+        auto pool = Loop->GetOptions().BulkPool;
+        std::size_t chunks = 0;
+        if (pool != nullptr && Shape > 0) {
+            chunks = std::min(pool->size(), static_cast<std::size_t>(Shape));
+        }
+        if (chunks <= 1) {
+            Run(0, Shape);
+            Complete();
+            return;
+        }
+
+        try {
+            Chunks = std::make_unique<TChunk[]>(chunks);
+        } catch (...) {
+            Error = std::current_exception();
+            Complete();
+            return;
+        }
+        Pending.store(chunks, std::memory_order_relaxed);
+        auto step = Shape / static_cast<TShape>(chunks);
+        auto rest = Shape % static_cast<TShape>(chunks);
+        auto first = pool->Pick(EBalancing::RoundRobin);
+        TShape begin = 0;
+        for (std::size_t c = 0; c < chunks; ++c) {
+            auto& chunk = Chunks[c];
+            chunk.Op = this;
+            chunk.Begin = begin;
+            chunk.End = begin + step + (static_cast<TShape>(c) < rest ? 1 : 0);
+            begin = chunk.End;
+        }
+        // Chunks can't be touched after scheduling the last one, the whole op state may be gone by then
+        for (std::size_t c = 0; c < chunks; ++c) {
+            pool->Loop((first + c) % pool->size()).Schedule(Chunks[c]);
+        }
+    }
+
+    void Run(TShape begin, TShape end) noexcept {
+        try {
+            std::visit([&]<typename TTuple>(TTuple& values) {
+                if constexpr (!std::same_as<TTuple, std::monostate>) {
+                    std::apply([&](auto&... args) {
+                        for (auto i = begin; i < end; ++i) {
+                            Fun(i, args...);
+                        }
+                    }, values);
+                }
+            }, Values);
+        } catch (...) {
+            if (!Failed.test_and_set(std::memory_order_relaxed)) {
+                Error = std::current_exception(); // Published by the Pending counter
+            }
+        }
+    }
+
+    void Complete() noexcept {
+        if (Error) {
+            stdexec::set_error(*std::move(Receiver), std::move(Error));
+            return;
+        }
+        std::visit([&]<typename TTuple>(TTuple& values) {
+            if constexpr (!std::same_as<TTuple, std::monostate>) {
+                std::apply([&](auto&... args) {
+                    stdexec::set_value(*std::move(Receiver), std::move(args)...);
+                }, values);
+            }
+        }, Values);
+    }
+
+private:
+    TOpState Op;
+    TCompletion Completion;
+    TLoop* Loop;
+    TShape Shape;
+    TFun Fun;
+    TValues Values;
+    std::optional<TReceiver> Receiver;
+    std::unique_ptr<TChunk[]> Chunks;
+    std::atomic_size_t Pending;
+    std::atomic_flag Failed;
+    std::exception_ptr Error;
+};
+
+}
@@ -18,9 +18,30 @@
 #include <uvexec/execution/error_code.hpp>
 #include <stdexec/execution.hpp>
 
+#include <tuple>
+#include <type_traits>
+#include <variant>
+
 
 namespace NUvExec {
 
+namespace NDetail {
+
+template <typename... Ts>
+using TDecayedTuple = std::tuple<std::decay_t<Ts>...>;
+
+template <typename... Ts>
+using TNullableVariant = std::variant<std::monostate, Ts...>;
+
+template <typename... Ts>
+using TDecayedNullableVariant = std::variant<std::monostate, std::decay_t<Ts>...>;
+
+// Values stored by an operation and sent later from another thread are sent as rvalues of decayed types
+template <typename... Ts>
+using TDecayedValueCompletionSignatures = stdexec::completion_signatures<stdexec::set_value_t(std::decay_t<Ts>...)>;
+
+}
+
 template <typename... TArgs>
 using TVoidValueCompletionSignatures = stdexec::completion_signatures<stdexec::set_value_t()>;
 
@@ -16,6 +16,7 @@
 #pragma once
 
 #include <uvexec/execution/error_code.hpp>
+#include <uvexec/execution/loop_trace.hpp>
 
 #include <uvexec/uv_util/reqs.hpp>
 #include <uvexec/uv_util/misc.hpp>
@@ -47,6 +48,8 @@ public:
             auto err = NUvUtil::Connect(ConnectReq, socket, NUvUtil::RawUvObject(ep), ConnectCallback);
             if (NUvUtil::IsError(err)) {
                 stdexec::set_error(std::move(*this).base(), EErrc{err});
+            } else {
+                Trace.Begin(NUvUtil::GetLoop(socket), "connect");
             }
         }
     }
@@ -54,6 +57,7 @@ public:
 private:
     static void ConnectCallback(uv_connect_t* req, NUvUtil::TUvError status) {
         auto self = static_cast<TConnectReceiver*>(req->data);
+        self->Trace.End();
         if (NUvUtil::IsError(status)) {
             stdexec::set_error(std::move(*self).base(), EErrc{status});
         } else {
@@ -64,6 +68,7 @@ private:
 private:
     uv_connect_t ConnectReq;
     TStreamSocket* Socket;
+    [[no_unique_address]] TTraceSpan Trace;
 };
 
 }
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2024 Michael Guzov
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "every_op_state.hpp"
+
+
+namespace NUvExec {
+
+template <stdexec::sender TSender, typename TFn>
+class TEverySender {
+public:
+    using sender_concept = stdexec::sender_t;
+
+public:
+    // Periods below the resolution of the loop timers would only spin the loop
+    TEverySender(TSender sender, TLoop& loop, TLoopClock::duration period, TFn fn)
+        : Sender(std::move(sender))
+        , Loop{&loop}
+        , Period(std::max<TLoopClock::duration>(period, std::chrono::microseconds{1}))
+        , Fn(std::move(fn))
+    {}
+
+    template <stdexec::receiver TReceiver>
+    friend auto tag_invoke(stdexec::connect_t, TEverySender s, TReceiver&& rec) {
+        return TEveryOpState<TSender, std::decay_t<TReceiver>, TFn>(
+                *s.Loop, s.Period, std::move(s.Fn), std::move(s.Sender), std::forward<TReceiver>(rec));
+    }
+
+    friend auto tag_invoke(stdexec::get_env_t, const TEverySender& s) noexcept {
+        return stdexec::get_env(s.Sender);
+    }
+
+    template <typename TEnv>
+    friend auto tag_invoke(stdexec::get_completion_signatures_t, const TEverySender&, const TEnv&) noexcept {
+        return stdexec::make_completion_signatures<TSender, TEnv,
+                TCancellableAlgorithmCompletionSignatures, TVoidValueCompletionSignatures>{};
+    }
+
+private:
+    TSender Sender;
+    TLoop* Loop;
+    TLoopClock::duration Period;
+    [[no_unique_address]] TFn Fn;
+};
+
+template <stdexec::sender TSender, typename TRep, typename TPeriod, typename TFn> requires
+        std::same_as<TLoop::TScheduler, std::invoke_result_t<
+                stdexec::get_completion_scheduler_t<stdexec::set_value_t>, stdexec::env_of_t<TSender>>> &&
+        std::convertible_to<std::chrono::duration<TRep, TPeriod>, TLoopClock::duration>
+auto tag_invoke(TLoop::TDomain d,
+        TSenderPackage<uvexec::every_t, TSender, std::tuple<std::chrono::duration<TRep, TPeriod>, TFn>> s)
+        noexcept(std::is_nothrow_constructible_v<std::decay_t<TSender>, TSender> &&
+                std::is_nothrow_move_constructible_v<TFn>) {
+    auto sch = stdexec::get_completion_scheduler<stdexec::set_value_t>(stdexec::get_env(s));
+    return TEverySender<std::decay_t<TSender>, TFn>(
+            std::move(s.Sender), d.GetLoop(sch), std::get<0>(s.Data), std::get<1>(std::move(s.Data)));
+}
+
+template <stdexec::sender TSender, typename TEnv, typename TRep, typename TPeriod, typename TFn> requires
+        std::same_as<TLoop::TScheduler, std::invoke_result_t<stdexec::get_scheduler_t, const TEnv&>> &&
+        std::convertible_to<std::chrono::duration<TRep, TPeriod>, TLoopClock::duration>
+auto tag_invoke(TLoop::TDomain d,
+        TSenderPackage<uvexec::every_t, TSender, std::tuple<std::chrono::duration<TRep, TPeriod>, TFn>> s,
+        const TEnv& e) noexcept(std::is_nothrow_constructible_v<std::decay_t<TSender>, TSender> &&
+                std::is_nothrow_move_constructible_v<TFn>) {
+    auto sch = stdexec::get_scheduler(e);
+    return TEverySender<std::decay_t<TSender>, TFn>(
+            std::move(s.Sender), d.GetLoop(sch), std::get<0>(s.Data), std::get<1>(std::move(s.Data)));
+}
+
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2024 Michael Guzov
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "completion_signatures.hpp"
+#include <uvexec/execution/loop.hpp>
+
+
+namespace NUvExec {
+
+template <stdexec::sender TSender, stdexec::receiver TReceiver, typename TFn>
+class TEveryOpState final : public TLoop::TTimer {
+    class TEveryReceiver final : public stdexec::receiver_adaptor<TEveryReceiver, TReceiver> {
+        friend stdexec::receiver_adaptor<TEveryReceiver, TReceiver>;
+
+    public:
+        TEveryReceiver(TEveryOpState& op, TReceiver&& rec) noexcept
+            : stdexec::receiver_adaptor<TEveryReceiver, TReceiver>(std::move(rec)), Op{&op}
+        {}
+
+        void set_value() noexcept {
+            Op->Receiver.emplace(std::move(*this).base());
+            Op->Trace.Begin(NUvUtil::RawUvObject(*Op->Loop), "every");
+            Op->StopOp.Setup();
+            Op->Next = TLoopClock::now() + Op->Period;
+            Op->Loop->StartTimer(*Op, Op->Next);
+        }
+
+    private:
+        TEveryOpState* Op;
+    };
+
+    using TOpState = stdexec::connect_result_t<TSender, TEveryReceiver>;
+
+public:
+    TEveryOpState(TLoop& loop, TLoopClock::duration period, TFn&& fn, TSender&& sender, TReceiver&& receiver)
+        : StopOp(StopCallback, *this, loop, stdexec::get_stop_token(stdexec::get_env(receiver)))
+        , Op(stdexec::connect(std::move(sender), TEveryReceiver(*this, std::move(receiver))))
+        , Loop{&loop}
+        , Period{period}
+        , Fn(std::move(fn))
+    {}
+
+    friend void tag_invoke(stdexec::start_t, TEveryOpState& op) noexcept {
+        stdexec::start(op.Op);
+    }
+
+    void Fire() noexcept override {
+        if (!StopOp) {
+            return; // Stop callback is on its way
+        }
+        // Ticks follow the first deadline rather than the time the previous one was handled at, so they don't drift.
+        // The ones missed by a late loop are merged into a single call
+        auto elapsed = 1 + (TLoopClock::now() - Next) / Period;
+        Next += elapsed * Period;
+        if (std::invoke(Fn, static_cast<std::size_t>(elapsed))) {
+            Loop->StartTimer(*this, Next);
+        } else if (!StopOp.Reset()) {
+            Trace.End();
+            stdexec::set_value(*std::move(Receiver));
+        }
+    }
+
+private:
+    static void StopCallback(TEveryOpState& op) noexcept {
+        op.Loop->StopTimer(op);
+        op.Trace.End();
+        stdexec::set_stopped(*std::move(op.Receiver));
+    }
+
+    using TStopToken = stdexec::stop_token_of_t<stdexec::env_of_t<TReceiver>>;
+
+private:
+    TLoop::TStopOperation<TEveryOpState, TStopToken> StopOp;
+    TOpState Op;
+    TLoop* Loop;
+    std::optional<TReceiver> Receiver;
+    TLoopClock::duration Period;
+    TLoopClock::time_point Next;
+    [[no_unique_address]] TFn Fn;
+    [[no_unique_address]] TTraceSpan Trace;
+};
+
+}
@@ -46,6 +46,7 @@ class TReadSomeOpState {
                 stdexec::set_error(std::move(*this).base(), EErrc{err});
             } else {
                 Op->Receiver.emplace(std::move(*this).base());
+                Op->Trace.Begin(NUvUtil::GetLoop(NUvUtil::RawUvObject(*Op->Stream)), "read_some");
                 Op->StopOp.Setup();
             }
         }
@@ -77,6 +78,7 @@ private:
             return;
         }
         if (!self->StopOp.Reset()) {
+            self->Trace.End();
             NUvUtil::ReadStop(tcp);
             if (nrd < 0) {
                 if (nrd == UV_EOF) {
@@ -99,6 +101,7 @@ private:
     static void StopCallback(TReadSomeOpState& op) noexcept {
         op.StopOp.ResetUnsafe();
         NUvUtil::ReadStop(NUvUtil::RawUvObject(*op.Stream));
+        op.Trace.End();
         stdexec::set_stopped(*std::move(op.Receiver));
     }
 
@@ -110,6 +113,7 @@ private:
     std::span<std::byte> Buf;
     TStream* Stream;
     std::optional<TReceiver> Receiver;
+    [[no_unique_address]] TTraceSpan Trace;
 };
 
 }
@@ -42,6 +42,7 @@ class TReadUntilOpState {
                 stdexec::set_error(std::move(*this).base(), EErrc{err});
             } else {
                 Op->Receiver.emplace(std::move(*this).base());
+                Op->Trace.Begin(NUvUtil::GetLoop(NUvUtil::RawUvObject(*Op->Stream)), "read_until");
                 Op->StopOp.Setup();
             }
         }
@@ -76,6 +77,7 @@ private:
         }
         if (nrd < 0) {
             if (!self->StopOp.Reset()) {
+                self->Trace.End();
                 NUvUtil::ReadStop(tcp);
                 if (nrd == UV_EOF) {
                     stdexec::set_value(*std::move(self->Receiver), static_cast<std::size_t>(self->ReadTotal));
@@ -87,6 +89,7 @@ private:
             self->ReadTotal += nrd;
             if (self->Condition(static_cast<std::size_t>(nrd))) {
                 if (!self->StopOp.Reset()) {
+                    self->Trace.End();
                     NUvUtil::ReadStop(tcp);
                     stdexec::set_value(*std::move(self->Receiver), self->ReadTotal);
                 }
@@ -103,6 +106,7 @@ private:
     static void StopCallback(TReadUntilOpState& op) noexcept {
         op.StopOp.ResetUnsafe();
         NUvUtil::ReadStop(NUvUtil::RawUvObject(*op.Stream));
+        op.Trace.End();
         stdexec::set_stopped(*std::move(op.Receiver));
     }
 
@@ -116,6 +120,7 @@ private:
     TStream* Stream;
     std::size_t ReadTotal;
     std::optional<TReceiver> Receiver;
+    [[no_unique_address]] TTraceSpan Trace;
 };
 
 }
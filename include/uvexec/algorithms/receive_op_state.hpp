@@ -46,6 +46,7 @@ class TReceiveOpState {
                 stdexec::set_error(std::move(*this).base(), EErrc{err});
             } else {
                 Op->Receiver.emplace(std::move(*this).base());
+                Op->Trace.Begin(NUvUtil::GetLoop(NUvUtil::RawUvObject(*Op->Socket)), "receive");
                 Op->StopOp.Setup();
             }
         }
@@ -78,6 +79,7 @@ private:
         }
         auto self = static_cast<TReceiveOpState*>(udp->data);
         if (!self->StopOp.Reset()) {
+            self->Trace.End();
             NUvUtil::ReceiveStop(*udp);
             if (nrd < 0) {
                 stdexec::set_error(*std::move(self->Receiver), EErrc{static_cast<NUvUtil::TUvError>(nrd)});
@@ -96,6 +98,7 @@ private:
     static void StopCallback(TReceiveOpState& op) noexcept {
         op.StopOp.ResetUnsafe();
         NUvUtil::ReceiveStop(NUvUtil::RawUvObject(*op.Socket));
+        op.Trace.End();
         stdexec::set_stopped(*std::move(op.Receiver));
     }
 
@@ -107,6 +110,7 @@ private:
     std::span<std::byte> Buf;
     TSocket* Socket;
     std::optional<TReceiver> Receiver;
+    [[no_unique_address]] TTraceSpan Trace;
 };
 
 template <typename TSocket, NMeta::IsIn<uvexec::endpoints_of_t<TSocket>> TEndpoint,
@@ -134,6 +138,7 @@ class TReceiveFromOpState {
                 stdexec::set_error(std::move(*this).base(), EErrc{err});
             } else {
                 Op->Receiver.emplace(std::move(*this).base());
+                Op->Trace.Begin(NUvUtil::GetLoop(NUvUtil::RawUvObject(*Op->Socket)), "receive_from");
                 Op->StopOp.Setup();
             }
         }
@@ -166,6 +171,7 @@ private:
         }
         auto self = static_cast<TReceiveFromOpState*>(udp->data);
         if (!self->StopOp.Reset()) {
+            self->Trace.End();
             NUvUtil::ReceiveStop(*udp);
             if (nrd < 0) {
                 stdexec::set_error(*std::move(self->Receiver), EErrc{static_cast<NUvUtil::TUvError>(nrd)});
@@ -189,6 +195,7 @@ private:
     static void StopCallback(TReceiveFromOpState& op) noexcept {
         op.StopOp.ResetUnsafe();
         NUvUtil::ReceiveStop(NUvUtil::RawUvObject(*op.Socket));
+        op.Trace.End();
         stdexec::set_stopped(*std::move(op.Receiver));
     }
 
@@ -201,6 +208,7 @@ private:
     TSocket* Socket;
     TEndpoint* Endpoint;
     std::optional<TReceiver> Receiver;
+    [[no_unique_address]] TTraceSpan Trace;
 };
 
 }
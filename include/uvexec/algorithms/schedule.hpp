@@ -25,25 +25,83 @@ public:
     using sender_concept = stdexec::sender_t;
     using completion_signatures = TScheduleCompletionSignatures;
 
-    explicit TScheduleSender(TLoop& loop) noexcept
-        : Loop{&loop}
+    TScheduleSender(TLoop& loop, EPriority priority) noexcept
+        : Loop{&loop}, Priority{priority}
     {}
 
     template <stdexec::receiver_of<completion_signatures> TReceiver>
     friend auto tag_invoke(stdexec::connect_t, TScheduleSender s, TReceiver&& rec) {
-        return TScheduleOpState<std::decay_t<TReceiver>>(*s.Loop, std::forward<TReceiver>(rec));
+        return TScheduleOpState<std::decay_t<TReceiver>>(*s.Loop, s.Priority, std::forward<TReceiver>(rec));
     }
 
     friend auto tag_invoke(stdexec::get_env_t, const TScheduleSender& s) noexcept {
-        return TLoop::TScheduler::TEnv(*s.Loop);
+        return TLoop::TScheduler::TEnv(*s.Loop, s.Priority);
     }
 
 private:
     TLoop* Loop;
+    EPriority Priority;
 };
 
 inline auto tag_invoke(stdexec::schedule_t, TLoop::TScheduler s) noexcept {
-    return TScheduleSender(TLoop::TDomain{}.GetLoop(s));
+    TLoop::TDomain d;
+    return TScheduleSender(d.GetLoop(s), d.GetPriority(s));
+}
+
+class TDeadlineScheduleSender {
+public:
+    using sender_concept = stdexec::sender_t;
+    using completion_signatures = TScheduleCompletionSignatures;
+
+    explicit TDeadlineScheduleSender(TLoop& loop) noexcept
+        : Loop{&loop}
+    {}
+
+    template <stdexec::receiver_of<completion_signatures> TReceiver>
+    friend auto tag_invoke(stdexec::connect_t, TDeadlineScheduleSender s, TReceiver&& rec) {
+        return TDeadlineScheduleOpState<std::decay_t<TReceiver>>(*s.Loop, std::forward<TReceiver>(rec));
+    }
+
+    friend auto tag_invoke(stdexec::get_env_t, const TDeadlineScheduleSender& s) noexcept {
+        return TLoop::TDeadlineScheduler::TEnv(*s.Loop);
+    }
+
+private:
+    TLoop* Loop;
+};
+
+inline auto tag_invoke(stdexec::schedule_t, TLoop::TDeadlineScheduler s) noexcept {
+    return TDeadlineScheduleSender(TLoop::TDomain{}.GetLoop(s));
+}
+
+static_assert(stdexec::scheduler<TLoop::TDeadlineScheduler>);
+
+class TPoolScheduleSender {
+public:
+    using sender_concept = stdexec::sender_t;
+    using completion_signatures = TScheduleCompletionSignatures;
+
+    TPoolScheduleSender(TLoopPool& pool, EBalancing balancing) noexcept
+        : Pool{&pool}, Balancing{balancing}
+    {}
+
+    template <stdexec::receiver_of<completion_signatures> TReceiver>
+    friend auto tag_invoke(stdexec::connect_t, TPoolScheduleSender s, TReceiver&& rec) {
+        return TPoolScheduleOpState<std::decay_t<TReceiver>>(*s.Pool, s.Balancing, std::forward<TReceiver>(rec));
+    }
+
+    friend auto tag_invoke(stdexec::get_env_t, const TPoolScheduleSender& s) noexcept {
+        return TLoopPool::TScheduler::TEnv(*s.Pool, s.Balancing);
+    }
+
+private:
+    TLoopPool* Pool;
+    EBalancing Balancing;
+};
+
+inline auto tag_invoke(stdexec::schedule_t, TLoopPool::TScheduler s) noexcept {
+    TLoopPool::TDomain d;
+    return TPoolScheduleSender(d.GetPool(s), d.GetBalancing(s));
 }
 
 }
@@ -17,6 +17,7 @@
 
 #include "completion_signatures.hpp"
 #include <uvexec/execution/loop.hpp>
+#include <uvexec/execution/loop_pool.hpp>
 
 
 namespace NUvExec {
@@ -24,12 +25,14 @@ namespace NUvExec {
 template <stdexec::receiver_of<TScheduleCompletionSignatures> TReceiver>
 class TScheduleOpState final : public TLoop::TOperation {
 public:
-    TScheduleOpState(TLoop& loop, TReceiver&& receiver)
-        : Loop{&loop}, Receiver(std::move(receiver))
+    TScheduleOpState(TLoop& loop, EPriority priority, TReceiver&& receiver)
+        : Loop{&loop}, Receiver(std::move(receiver)), Priority{priority}
     {}
 
     friend void tag_invoke(stdexec::start_t, TScheduleOpState& op) noexcept {
-        op.Loop->Schedule(op);
+        if (!op.Submit()) {
+            stdexec::set_stopped(std::move(op.Receiver)); // Loop is overloaded
+        }
     }
 
     void Apply() noexcept override {
@@ -40,9 +43,95 @@ public:
         }
     }
 
+private:
+    auto Submit() noexcept -> bool {
+        using TEnv = stdexec::env_of_t<TReceiver>;
+        if constexpr (std::invocable<uvexec::get_schedule_batch_t, const TEnv&>) {
+            auto batch = uvexec::get_schedule_batch(stdexec::get_env(Receiver));
+            if (batch != nullptr && &batch->GetLoop() == Loop) {
+                return batch->TryPushBack(*this, Priority);
+            }
+        }
+        return Loop->TrySchedule(*this, Priority);
+    }
+
+private:
+    TLoop* Loop;
+    TReceiver Receiver;
+    EPriority Priority;
+};
+
+template <stdexec::receiver_of<TScheduleCompletionSignatures> TReceiver>
+class TDeadlineScheduleOpState final : public TLoop::TDeadlineOperation {
+public:
+    TDeadlineScheduleOpState(TLoop& loop, TReceiver&& receiver)
+        : Loop{&loop}, Receiver(std::move(receiver))
+    {}
+
+    friend void tag_invoke(stdexec::start_t, TDeadlineScheduleOpState& op) noexcept {
+        if (!op.Loop->TrySchedule(op)) {
+            stdexec::set_stopped(std::move(op.Receiver)); // Loop is overloaded
+        }
+    }
+
+    // Operation is ready, but it still waits for the ones with earlier deadlines
+    void Apply() noexcept override {
+        using TEnv = stdexec::env_of_t<TReceiver>;
+        if constexpr (std::invocable<uvexec::get_deadline_t, const TEnv&>) {
+            Deadline = std::chrono::time_point_cast<TLoopClock::duration>(
+                    uvexec::get_deadline(stdexec::get_env(Receiver)));
+        }
+        if (Expired()) {
+            stdexec::set_stopped(std::move(Receiver));
+        } else {
+            Loop->ScheduleByDeadline(*this);
+        }
+    }
+
+    void ApplyOrdered() noexcept override {
+        if (Expired() || stdexec::get_stop_token(stdexec::get_env(Receiver)).stop_requested()) {
+            stdexec::set_stopped(std::move(Receiver));
+        } else {
+            stdexec::set_value(std::move(Receiver));
+        }
+    }
+
+private:
+    auto Expired() const noexcept -> bool {
+        return exec::now(Loop->get_scheduler()) > Deadline;
+    }
+
 private:
     TLoop* Loop;
     TReceiver Receiver;
 };
 
+template <stdexec::receiver_of<TScheduleCompletionSignatures> TReceiver>
+class TPoolScheduleOpState final : public TLoop::TOperation {
+public:
+    TPoolScheduleOpState(TLoopPool& pool, EBalancing balancing, TReceiver&& receiver)
+        : Pool{&pool}, Receiver(std::move(receiver)), Balancing{balancing}, Worker{0}
+    {}
+
+    friend void tag_invoke(stdexec::start_t, TPoolScheduleOpState& op) noexcept {
+        op.Worker = op.Pool->Pick(op.Balancing);
+        op.Pool->Schedule(op.Worker, op, op.Balancing);
+    }
+
+    void Apply() noexcept override {
+        Pool->Release(Worker);
+        if (Pool->Stopped() || stdexec::get_stop_token(stdexec::get_env(Receiver)).stop_requested()) {
+            stdexec::set_stopped(std::move(Receiver));
+        } else {
+            stdexec::set_value(std::move(Receiver));
+        }
+    }
+
+private:
+    TLoopPool* Pool;
+    TReceiver Receiver;
+    EBalancing Balancing;
+    std::size_t Worker;
+};
+
 }
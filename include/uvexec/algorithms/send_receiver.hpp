@@ -16,6 +16,7 @@
 #pragma once
 
 #include <uvexec/execution/error_code.hpp>
+#include <uvexec/execution/loop_trace.hpp>
 
 #include <uvexec/uv_util/reqs.hpp>
 #include <uvexec/uv_util/misc.hpp>
@@ -39,6 +40,8 @@ public:
         auto err = NUvUtil::Send(SendReq, NUvUtil::RawUvObject(*Handle), buffs, SendCallback);
         if (NUvUtil::IsError(err)) {
             stdexec::set_error(std::move(*this).base(), EErrc{err});
+        } else {
+            Trace.Begin(NUvUtil::GetLoop(NUvUtil::RawUvObject(*Handle)), "send");
         }
     }
 
@@ -54,6 +57,7 @@ public:
 private:
     static void SendCallback(uv_udp_send_t* req, NUvUtil::TUvError status) {
         auto self = static_cast<TSendReceiver*>(req->data);
+        self->Trace.End();
         if (NUvUtil::IsError(status)) {
             stdexec::set_error(std::move(*self).base(), EErrc{status});
         } else {
@@ -65,6 +69,7 @@ private:
     uv_udp_send_t SendReq;
     uv_buf_t Buf;
     TSocket* Handle;
+    [[no_unique_address]] TTraceSpan Trace;
 };
 
 template <stdexec::receiver TReceiver, typename TSocket>
@@ -82,6 +87,8 @@ public:
         auto err = NUvUtil::Send(SendReq, NUvUtil::RawUvObject(*Handle), buffs, SendCallback, NUvUtil::RawUvObject(ep));
         if (NUvUtil::IsError(err)) {
             stdexec::set_error(std::move(*this).base(), EErrc{err});
+        } else {
+            Trace.Begin(NUvUtil::GetLoop(NUvUtil::RawUvObject(*Handle)), "send_to");
         }
     }
 
@@ -95,6 +102,7 @@ public:
 private:
     static void SendCallback(uv_udp_send_t* req, NUvUtil::TUvError status) {
         auto self = static_cast<TSendToReceiver*>(req->data);
+        self->Trace.End();
         if (NUvUtil::IsError(status)) {
             stdexec::set_error(std::move(*self).base(), EErrc{status});
         } else {
@@ -106,6 +114,7 @@ private:
     uv_udp_send_t SendReq;
     uv_buf_t Buf;
     TSocket* Handle;
+    [[no_unique_address]] TTraceSpan Trace;
 };
 
 }
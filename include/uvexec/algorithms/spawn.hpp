@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2024 Michael Guzov
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "spawn_op_state.hpp"
+#include <uvexec/interface/uvexec.hpp>
+
+
+namespace uvexec {
+
+// exec::async_scope::spawn allocates its operation with the global operator new whatever the environment is.
+// This one nests the sender into the scope the same way, but takes the memory from get_allocator of the environment,
+// so with loop_t::TScheduler::TLoopEnv spawned operations live in the loop slabs
+template <typename TScope, stdexec::sender TSender, typename TEnv> requires requires (TScope& scope, TSender&& sender) {
+    scope.nest(std::forward<TSender>(sender));
+    { scope.get_stop_token() } -> std::same_as<stdexec::in_place_stop_token>;
+}
+void tag_invoke(spawn_t, TScope& scope, TSender&& sender, TEnv env) {
+    using TNested = decltype(scope.nest(std::forward<TSender>(sender)));
+    NUvExec::TSpawnOpState<TNested, TEnv>::Spawn(scope.nest(std::forward<TSender>(sender)),
+            NUvExec::TSpawnEnv<TEnv>(std::move(env), scope.get_stop_token()));
+}
+
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2024 Michael Guzov
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <stdexec/execution.hpp>
+
+#include <concepts>
+#include <exception>
+#include <memory>
+
+
+namespace NUvExec {
+
+template <typename TEnv>
+auto GetSpawnAllocator(const TEnv& env) noexcept {
+    if constexpr (stdexec::tag_invocable<stdexec::get_allocator_t, const TEnv&>) {
+        return stdexec::get_allocator(env);
+    } else {
+        return std::allocator<std::byte>();
+    }
+}
+
+// Spawn environment, its stop token is the one of the scope, as with exec::async_scope::spawn
+template <typename TEnv>
+class TSpawnEnv {
+public:
+    TSpawnEnv(TEnv env, stdexec::in_place_stop_token token) noexcept
+        : Env(std::move(env)), Token(std::move(token))
+    {}
+
+    friend auto tag_invoke(stdexec::get_stop_token_t, const TSpawnEnv& e) noexcept -> stdexec::in_place_stop_token {
+        return e.Token;
+    }
+
+    template <typename TTag, typename... TArgs> requires
+            (!std::same_as<TTag, stdexec::get_stop_token_t>) && (stdexec::forwarding_query(TTag{})) &&
+            stdexec::tag_invocable<TTag, const TEnv&, TArgs...>
+    friend auto tag_invoke(TTag tag, const TSpawnEnv& e, TArgs&&... args)
+            noexcept(stdexec::nothrow_tag_invocable<TTag, const TEnv&, TArgs...>)
+            -> stdexec::tag_invoke_result_t<TTag, const TEnv&, TArgs...> {
+        return stdexec::tag_invoke(tag, e.Env, std::forward<TArgs>(args)...);
+    }
+
+private:
+    TEnv Env;
+    stdexec::in_place_stop_token Token;
+};
+
+// Self-owning operation, it's allocated with the allocator of its environment and freed by its own completion
+template <stdexec::sender TSender, typename TEnv>
+class TSpawnOpState {
+    using TAllocator = typename std::allocator_traits<decltype(GetSpawnAllocator(std::declval<const TEnv&>()))>
+            ::template rebind_alloc<TSpawnOpState>;
+
+    class TSpawnReceiver : public stdexec::receiver_adaptor<TSpawnReceiver> {
+        friend stdexec::receiver_adaptor<TSpawnReceiver>;
+
+    public:
+        explicit TSpawnReceiver(TSpawnOpState& op) noexcept
+            : Op{&op}
+        {}
+
+        void set_value() noexcept {
+            Op->Destroy();
+        }
+
+        void set_error(std::exception_ptr) noexcept {
+            std::terminate(); // Nobody to report it to, as with exec::async_scope::spawn
+        }
+
+        void set_stopped() noexcept {
+            Op->Destroy();
+        }
+
+        [[nodiscard]]
+        auto get_env() const noexcept -> const TSpawnEnv<TEnv>& {
+            return Op->Env;
+        }
+
+    private:
+        TSpawnOpState* Op;
+    };
+
+    using TOpState = stdexec::connect_result_t<TSender, TSpawnReceiver>;
+
+public:
+    TSpawnOpState(TSender&& sender, TSpawnEnv<TEnv>&& env)
+        : Env(std::move(env))
+        , Op(stdexec::connect(std::move(sender), TSpawnReceiver(*this)))
+    {}
+
+    static void Spawn(TSender&& sender, TSpawnEnv<TEnv>&& env) {
+        TAllocator allocator(GetSpawnAllocator(env));
+        auto op = std::allocator_traits<TAllocator>::allocate(allocator, 1);
+        try {
+            std::allocator_traits<TAllocator>::construct(allocator, op, std::move(sender), std::move(env));
+        } catch (...) {
+            std::allocator_traits<TAllocator>::deallocate(allocator, op, 1);
+            throw;
+        }
+        stdexec::start(op->Op);
+    }
+
+private:
+    void Destroy() noexcept {
+        TAllocator allocator(GetSpawnAllocator(Env));
+        std::allocator_traits<TAllocator>::destroy(allocator, this);
+        std::allocator_traits<TAllocator>::deallocate(allocator, this, 1);
+    }
+
+private:
+    TSpawnEnv<TEnv> Env;
+    TOpState Op;
+};
+
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2024 Michael Guzov
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "transfer_op_state.hpp"
+
+
+namespace NUvExec {
+
+template <stdexec::sender TSender>
+class TTransferSender {
+public:
+    using sender_concept = stdexec::sender_t;
+
+public:
+    TTransferSender(TSender sender, TLoop& loop, EPriority priority)
+        : Sender(std::move(sender)), Loop{&loop}, Priority{priority}
+    {}
+
+    template <stdexec::receiver TReceiver>
+    friend auto tag_invoke(stdexec::connect_t, TTransferSender s, TReceiver&& rec) {
+        return TTransferOpState<TSender, std::decay_t<TReceiver>>(
+                *s.Loop, s.Priority, std::move(s.Sender), std::forward<TReceiver>(rec));
+    }
+
+    friend auto tag_invoke(stdexec::get_env_t, const TTransferSender& s) noexcept {
+        return TLoop::TScheduler::TEnv(*s.Loop, s.Priority);
+    }
+
+    template <typename TEnv>
+    friend auto tag_invoke(stdexec::get_completion_signatures_t, const TTransferSender&, const TEnv&) noexcept {
+        return stdexec::make_completion_signatures<TSender, TEnv,
+                TExceptionCompletionSignatures, NDetail::TDecayedValueCompletionSignatures>{};
+    }
+
+private:
+    TSender Sender;
+    TLoop* Loop;
+    EPriority Priority;
+};
+
+// Loop to loop hop: the completion is handed over as one operation, and all hops made by the source loop
+// to the same target during one phase share a single wakeup, see TLoop::Transfer
+template <stdexec::sender_expr_for<stdexec::transfer_t> TSender> requires
+        std::same_as<TLoop::TScheduler, std::invoke_result_t<
+                stdexec::get_completion_scheduler_t<stdexec::set_value_t>, stdexec::env_of_t<TSender>>> &&
+        std::same_as<TLoop::TScheduler, std::invoke_result_t<
+                stdexec::get_completion_scheduler_t<stdexec::set_value_t>,
+                stdexec::env_of_t<stdexec::__child_of<TSender>>>>
+auto tag_invoke(TLoop::TDomain d, TSender&& s) {
+    auto sch = stdexec::get_completion_scheduler<stdexec::set_value_t>(stdexec::get_env(s));
+    auto& loop = d.GetLoop(sch);
+    auto priority = d.GetPriority(sch);
+    return stdexec::__sexpr_apply(std::forward<TSender>(s), [&]<typename TChild>(
+            stdexec::__ignore, stdexec::__ignore, TChild&& child) {
+        return TTransferSender<std::decay_t<TChild>>(std::forward<TChild>(child), loop, priority);
+    });
+}
+
+}
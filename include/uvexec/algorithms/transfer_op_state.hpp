@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2024 Michael Guzov
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "completion_signatures.hpp"
+#include <uvexec/execution/loop.hpp>
+
+#include <exception>
+#include <optional>
+
+
+namespace NUvExec {
+
+// Completion of a sender running on one loop, stored and handed over to another loop as a single operation
+template <stdexec::sender TSender, stdexec::receiver TReceiver>
+class TTransferOpState final : public TLoop::TOperation {
+    using TEnv = stdexec::env_of_t<TReceiver>;
+    using TValues = stdexec::value_types_of_t<TSender, TEnv, NDetail::TDecayedTuple, NDetail::TNullableVariant>;
+    using TErrors = stdexec::error_types_of_t<TSender, TEnv, NDetail::TDecayedNullableVariant>;
+
+    class TTransferReceiver final : public stdexec::receiver_adaptor<TTransferReceiver, TReceiver> {
+        friend stdexec::receiver_adaptor<TTransferReceiver, TReceiver>;
+
+    public:
+        TTransferReceiver(TTransferOpState& op, TReceiver&& rec) noexcept
+            : stdexec::receiver_adaptor<TTransferReceiver, TReceiver>(std::move(rec)), Op{&op}
+        {}
+
+        template <typename... TArgs>
+        void set_value(TArgs&&... args) noexcept {
+            try {
+                Op->Values.template emplace<NDetail::TDecayedTuple<TArgs...>>(std::forward<TArgs>(args)...);
+            } catch (...) {
+                Op->Exception = std::current_exception();
+            }
+            Transfer();
+        }
+
+        template <typename TError>
+        void set_error(TError&& err) noexcept {
+            try {
+                Op->Errors.template emplace<std::decay_t<TError>>(std::forward<TError>(err));
+            } catch (...) {
+                Op->Exception = std::current_exception();
+            }
+            Transfer();
+        }
+
+        void set_stopped() noexcept {
+            Transfer();
+        }
+
+    private:
+        void Transfer() noexcept {
+            Op->Receiver.emplace(std::move(*this).base());
+            Op->Loop->Transfer(*Op, Op->Priority);
+        }
+
+    private:
+        TTransferOpState* Op;
+    };
+
+    using TOpState = stdexec::connect_result_t<TSender, TTransferReceiver>;
+
+public:
+    TTransferOpState(TLoop& loop, EPriority priority, TSender&& sender, TReceiver&& receiver)
+        : Op(stdexec::connect(std::move(sender), TTransferReceiver(*this, std::move(receiver))))
+        , Loop{&loop}
+        , Priority{priority}
+    {}
+
+    friend void tag_invoke(stdexec::start_t, TTransferOpState& op) noexcept {
+        stdexec::start(op.Op);
+    }
+
+    void Apply() noexcept override {
+        if (Exception) {
+            stdexec::set_error(*std::move(Receiver), std::move(Exception));
+        } else if (Values.index() != 0) {
+            std::visit([&]<typename TTuple>(TTuple& values) {
+                if constexpr (!std::same_as<TTuple, std::monostate>) {
+                    std::apply([&](auto&... args) {
+                        stdexec::set_value(*std::move(Receiver), std::move(args)...);
+                    }, values);
+                }
+            }, Values);
+        } else if (Errors.index() != 0) {
+            std::visit([&]<typename TError>(TError& err) {
+                if constexpr (!std::same_as<TError, std::monostate>) {
+                    stdexec::set_error(*std::move(Receiver), std::move(err));
+                }
+            }, Errors);
+        } else if constexpr (stdexec::sends_stopped<TSender, TEnv>) {
+            stdexec::set_stopped(*std::move(Receiver));
+        }
+    }
+
+private:
+    TOpState Op;
+    TLoop* Loop;
+    EPriority Priority;
+    TValues Values;
+    TErrors Errors;
+    std::exception_ptr Exception;
+    std::optional<TReceiver> Receiver;
+};
+
+}
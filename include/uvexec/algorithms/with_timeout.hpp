@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2024 Michael Guzov
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "with_timeout_op_state.hpp"
+#include <uvexec/interface/closure.hpp>
+
+
+namespace NUvExec {
+
+using TWithTimeoutCompletionSignatures = stdexec::completion_signatures<
+        stdexec::set_error_t(EErrc), stdexec::set_error_t(std::exception_ptr), stdexec::set_stopped_t()>;
+
+template <stdexec::sender TSender>
+class TWithTimeoutSender {
+public:
+    using sender_concept = stdexec::sender_t;
+
+public:
+    TWithTimeoutSender(TSender sender, TLoopClock::duration timeout)
+        : Sender(std::move(sender)), Timeout(std::max(timeout, TLoopClock::duration{0}))
+    {}
+
+    // The timer runs on the loop of the receiver environment, or else on the one the sender completes on
+    template <stdexec::receiver TReceiver>
+    friend auto tag_invoke(stdexec::connect_t, TWithTimeoutSender s, TReceiver&& rec) {
+        auto& loop = GetLoop(stdexec::get_env(rec), s.Sender);
+        return TWithTimeoutOpState<TSender, std::decay_t<TReceiver>>(
+                loop, s.Timeout, std::move(s.Sender), std::forward<TReceiver>(rec));
+    }
+
+    friend auto tag_invoke(stdexec::get_env_t, const TWithTimeoutSender& s) noexcept {
+        return stdexec::get_env(s.Sender);
+    }
+
+    template <typename TEnv>
+    friend auto tag_invoke(stdexec::get_completion_signatures_t, const TWithTimeoutSender&, const TEnv&) noexcept {
+        return stdexec::make_completion_signatures<TSender, TTimeoutEnv<TEnv>,
+                TWithTimeoutCompletionSignatures, NDetail::TDecayedValueCompletionSignatures>{};
+    }
+
+private:
+    template <typename TEnv>
+    static auto GetLoop(const TEnv& env, const TSender& sender) noexcept -> TLoop& {
+        if constexpr (requires { { stdexec::get_scheduler(env) } -> std::same_as<TLoop::TScheduler>; }) {
+            return TLoop::TDomain{}.GetLoop(stdexec::get_scheduler(env));
+        } else {
+            static_assert(std::same_as<TLoop::TScheduler, std::invoke_result_t<
+                    stdexec::get_completion_scheduler_t<stdexec::set_value_t>, stdexec::env_of_t<TSender>>>,
+                    "with_timeout needs a loop either in the receiver environment or as the completion scheduler");
+            return TLoop::TDomain{}.GetLoop(stdexec::get_completion_scheduler<stdexec::set_value_t>(
+                    stdexec::get_env(sender)));
+        }
+    }
+
+private:
+    TSender Sender;
+    TLoopClock::duration Timeout;
+};
+
+}
+
+namespace uvexec {
+
+// Completes with errc::timed_out if the sender is stopped because it hasn't completed within the timeout
+struct with_timeout_t {
+    template <typename TRep, typename TPer>
+    auto operator()(std::chrono::duration<TRep, TPer> timeout) const noexcept {
+        return NUvExec::TArgBinder<NUvExec::TLoopClock::duration, with_timeout_t>(timeout);
+    }
+
+    template <stdexec::sender TSender, typename TRep, typename TPer> requires
+            std::convertible_to<std::chrono::duration<TRep, TPer>, NUvExec::TLoopClock::duration>
+    auto operator()(TSender&& sender, std::chrono::duration<TRep, TPer> timeout) const noexcept(
+            std::is_nothrow_constructible_v<std::decay_t<TSender>, TSender>) -> stdexec::sender auto {
+        auto d = NUvExec::GetEarlyDomain(sender);
+        return stdexec::transform_sender(d, NUvExec::TWithTimeoutSender<std::decay_t<TSender>>(
+                std::forward<TSender>(sender), timeout));
+    }
+};
+
+inline constexpr with_timeout_t with_timeout;
+
+}
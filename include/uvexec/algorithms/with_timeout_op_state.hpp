@@ -0,0 +1,270 @@
+/*
+ * Copyright (c) 2024 Michael Guzov
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "completion_signatures.hpp"
+#include <uvexec/execution/loop.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <optional>
+
+
+namespace NUvExec {
+
+// Environment of the wrapped operation, its stop token is also triggered by the timeout
+template <typename TEnv>
+class TTimeoutEnv {
+public:
+    TTimeoutEnv(TEnv env, stdexec::in_place_stop_token token) noexcept
+        : Env(std::move(env)), Token(std::move(token))
+    {}
+
+    friend auto tag_invoke(stdexec::get_stop_token_t, const TTimeoutEnv& e) noexcept -> stdexec::in_place_stop_token {
+        return e.Token;
+    }
+
+    template <typename TTag, typename... TArgs> requires
+            (!std::same_as<TTag, stdexec::get_stop_token_t>) && (stdexec::forwarding_query(TTag{})) &&
+            stdexec::tag_invocable<TTag, const TEnv&, TArgs...>
+    friend auto tag_invoke(TTag tag, const TTimeoutEnv& e, TArgs&&... args)
+            noexcept(stdexec::nothrow_tag_invocable<TTag, const TEnv&, TArgs...>)
+            -> stdexec::tag_invoke_result_t<TTag, const TEnv&, TArgs...> {
+        return stdexec::tag_invoke(tag, e.Env, std::forward<TArgs>(args)...);
+    }
+
+private:
+    TEnv Env;
+    stdexec::in_place_stop_token Token;
+};
+
+// The timer is an intrusive entry of the loop timing wheel, it's armed and cancelled by the loop thread.
+// Completions on the loop are forwarded as they are, the ones from other threads are stored and handed over to it.
+// So are the ones made from within a stop request: the receiver may destroy the stop source still being signalled.
+// Whether a stopped completion is reported as a timeout is decided when it's made, the timer may still fire before
+// a handed over completion is applied
+template <stdexec::sender TSender, stdexec::receiver TReceiver>
+class TWithTimeoutOpState final : public TLoop::TOperation, public TLoop::TTimer {
+    using TEnv = TTimeoutEnv<stdexec::env_of_t<TReceiver>>;
+    using TValues = stdexec::value_types_of_t<TSender, TEnv, NDetail::TDecayedTuple, NDetail::TNullableVariant>;
+    using TErrors = stdexec::error_types_of_t<TSender, TEnv, NDetail::TDecayedNullableVariant>;
+
+    class TTimeoutReceiver final : public stdexec::receiver_adaptor<TTimeoutReceiver, TReceiver> {
+        friend stdexec::receiver_adaptor<TTimeoutReceiver, TReceiver>;
+
+    public:
+        TTimeoutReceiver(TWithTimeoutOpState& op, TReceiver&& rec) noexcept
+            : stdexec::receiver_adaptor<TTimeoutReceiver, TReceiver>(std::move(rec)), Op{&op}
+        {}
+
+        template <typename... TArgs>
+        void set_value(TArgs&&... args) noexcept {
+            Op->Complete();
+            if (Op->CompletesInline()) {
+                Op->Finish();
+                stdexec::set_value(std::move(*this).base(), std::forward<TArgs>(args)...);
+                return;
+            }
+            try {
+                Op->Values.template emplace<NDetail::TDecayedTuple<TArgs...>>(std::forward<TArgs>(args)...);
+            } catch (...) {
+                Op->Exception = std::current_exception();
+            }
+            Op->Handover(std::move(*this).base());
+        }
+
+        template <typename TError>
+        void set_error(TError&& err) noexcept {
+            Op->Complete();
+            if (Op->CompletesInline()) {
+                Op->Finish();
+                stdexec::set_error(std::move(*this).base(), std::forward<TError>(err));
+                return;
+            }
+            try {
+                Op->Errors.template emplace<std::decay_t<TError>>(std::forward<TError>(err));
+            } catch (...) {
+                Op->Exception = std::current_exception();
+            }
+            Op->Handover(std::move(*this).base());
+        }
+
+        void set_stopped() noexcept {
+            Op->Complete();
+            if (Op->CompletesInline()) {
+                Op->Finish();
+                Op->SetStopped(std::move(*this).base());
+                return;
+            }
+            Op->Handover(std::move(*this).base());
+        }
+
+        [[nodiscard]]
+        auto get_env() const noexcept -> TEnv {
+            return TEnv(stdexec::get_env(this->base()), Op->StopSource.get_token());
+        }
+
+    private:
+        TWithTimeoutOpState* Op;
+    };
+
+    using TOpState = stdexec::connect_result_t<TSender, TTimeoutReceiver>;
+
+    struct TForwardStop {
+        void operator()() const noexcept {
+            Op->RequestStop(EState::Stopped);
+        }
+
+        TWithTimeoutOpState* Op;
+    };
+
+    using TStopToken = stdexec::stop_token_of_t<stdexec::env_of_t<TReceiver>>;
+    using TStopCallback = typename TStopToken::template callback_type<TForwardStop>;
+
+public:
+    TWithTimeoutOpState(TLoop& loop, TLoopClock::duration timeout, TSender&& sender, TReceiver&& receiver)
+        : Token(stdexec::get_stop_token(stdexec::get_env(receiver)))
+        , Op(stdexec::connect(std::move(sender), TTimeoutReceiver(*this, std::move(receiver))))
+        , Loop{&loop}
+        , Timeout{timeout}
+    {}
+
+    friend void tag_invoke(stdexec::start_t, TWithTimeoutOpState& op) noexcept {
+        if (op.OnLoop()) {
+            op.Arm();
+        } else {
+            op.Loop->Schedule(op);
+        }
+    }
+
+    void Apply() noexcept override {
+        if (!Started) {
+            Arm();
+            return;
+        }
+        Finish();
+        if (Exception) {
+            stdexec::set_error(*std::move(Receiver), std::move(Exception));
+        } else if (Values.index() != 0) {
+            std::visit([&]<typename TTuple>(TTuple& values) {
+                if constexpr (!std::same_as<TTuple, std::monostate>) {
+                    std::apply([&](auto&... args) {
+                        stdexec::set_value(*std::move(Receiver), std::move(args)...);
+                    }, values);
+                }
+            }, Values);
+        } else if (Errors.index() != 0) {
+            std::visit([&]<typename TError>(TError& err) {
+                if constexpr (!std::same_as<TError, std::monostate>) {
+                    stdexec::set_error(*std::move(Receiver), std::move(err));
+                }
+            }, Errors);
+        } else {
+            SetStopped(*std::move(Receiver));
+        }
+    }
+
+    void Fire() noexcept override {
+        RequestStop(EState::TimedOut);
+    }
+
+private:
+    enum class EState : std::uint8_t {
+        Running,
+        // Stop was requested by the receiver or by the timer, whichever came first
+        Stopped,
+        TimedOut,
+        Completed,
+    };
+
+private:
+    auto OnLoop() const noexcept -> bool {
+        return TLoop::Current() == Loop;
+    }
+
+    auto CompletesInline() const noexcept -> bool {
+        return OnLoop() && !Stopping;
+    }
+
+    void RequestStop(EState reason) noexcept {
+        auto running = EState::Running;
+        if (!State.compare_exchange_strong(running, reason, std::memory_order_acq_rel)) {
+            return; // Already completed, or stop is already requested for the other reason
+        }
+        // Only the loop thread looks at the flag, stop requests from other threads are handed over anyway
+        if (!OnLoop()) {
+            StopSource.request_stop();
+            return;
+        }
+        Stopping = true;
+        StopSource.request_stop();
+        Stopping = false;
+    }
+
+    void Arm() noexcept {
+        Started = true;
+        Trace.Begin(NUvUtil::RawUvObject(*Loop), "with_timeout");
+        StopCallback.emplace(std::move(Token), TForwardStop{this});
+        Loop->StartTimer(*this, TLoopClock::now() + Timeout);
+        stdexec::start(Op);
+    }
+
+    // Called by the completion before anything else, the one exchange that decides between it and the timer
+    void Complete() noexcept {
+        TimedOut = State.exchange(EState::Completed, std::memory_order_acq_rel) == EState::TimedOut;
+    }
+
+    void Finish() noexcept {
+        StopCallback.reset();
+        Loop->StopTimer(*this);
+        Trace.End();
+    }
+
+    void Handover(TReceiver&& receiver) noexcept {
+        Receiver.emplace(std::move(receiver));
+        Loop->Schedule(*this);
+    }
+
+    void SetStopped(TReceiver&& receiver) noexcept {
+        if (TimedOut) {
+            stdexec::set_error(std::move(receiver), EErrc::timed_out);
+        } else {
+            stdexec::set_stopped(std::move(receiver));
+        }
+    }
+
+private:
+    TStopToken Token;
+    // Constructed before the wrapped operation, which may ask for its token when connected
+    stdexec::in_place_stop_source StopSource;
+    TOpState Op;
+    TLoop* Loop;
+    TLoopClock::duration Timeout;
+    std::optional<TStopCallback> StopCallback;
+    std::optional<TReceiver> Receiver;
+    TValues Values;
+    TErrors Errors;
+    std::exception_ptr Exception;
+    std::atomic<EState> State{EState::Running};
+    bool Started{false};
+    // Written by the completion, read by the loop thread once it's applied
+    bool TimedOut{false};
+    bool Stopping{false};
+    [[no_unique_address]] TTraceSpan Trace;
+};
+
+}
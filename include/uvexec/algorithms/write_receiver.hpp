@@ -16,6 +16,7 @@
 #pragma once
 
 #include <uvexec/execution/error_code.hpp>
+#include <uvexec/execution/loop_trace.hpp>
 
 #include <uvexec/uv_util/reqs.hpp>
 #include <uvexec/uv_util/misc.hpp>
@@ -39,6 +40,8 @@ public:
         auto err = NUvUtil::Write(WriteReq, NUvUtil::RawUvObject(*Handle), buffs, WriteCallback);
         if (NUvUtil::IsError(err)) {
             stdexec::set_error(std::move(*this).base(), EErrc{err});
+        } else {
+            Trace.Begin(NUvUtil::GetLoop(NUvUtil::RawUvObject(*Handle)), "write");
         }
     }
 
@@ -51,6 +54,7 @@ public:
 private:
     static void WriteCallback(uv_write_t* req, NUvUtil::TUvError status) {
         auto self = static_cast<TWriteReceiver*>(req->data);
+        self->Trace.End();
         if (NUvUtil::IsError(status)) {
             stdexec::set_error(std::move(*self).base(), EErrc{status});
         } else {
@@ -62,6 +66,7 @@ private:
     uv_write_t WriteReq;
     uv_buf_t Buf;
     TSocket* Handle;
+    [[no_unique_address]] TTraceSpan Trace;
 };
 
 }
@@ -15,8 +15,13 @@
  */
 #pragma once
 
+#include "loop_allocator.hpp"
 #include "loop_clock.hpp"
+#include "loop_metrics.hpp"
+#include "loop_timer.hpp"
+#include "loop_trace.hpp"
 #include "sync_wait_receiver.hpp"
+#include "timer_wheel.hpp"
 #include "runner.hpp"
 
 #include <uvexec/interface/uvexec.hpp>
@@ -30,6 +35,10 @@
 
 #include <uvexec/util/intrusive_list.hpp>
 
+#include <array>
+#include <memory>
+#include <vector>
+
 
 namespace NUvExec {
 
@@ -41,22 +50,170 @@ using TCallbackOf = typename stdexec::stop_token_of_t<stdexec::env_of_t<TReceive
 
 }
 
+class TLoopPool;
+
+// Lanes are drained in this order, yet lower ones always keep a share of the batch budget
+enum class EPriority {
+    High,
+    Normal,
+    Low,
+    Idle // Background work applied only by iterations which polled no I/O events
+};
+
+struct TLoopOptions {
+    // Max amount of scheduled operations applied per loop iteration, the rest is postponed to the next one
+    std::size_t BatchBudget{1024};
+    // Time the loop busy-polls without blocking after the last activity, zero disables spinning
+    std::chrono::nanoseconds SpinBudget{0};
+    // Loops running iterations of stdexec::bulk started on this loop, bulk runs serially on the loop itself if unset
+    TLoopPool* BulkPool{nullptr};
+    // Enables TLoop::GetMetrics, which counts with a few relaxed atomic increments per operation
+    bool CollectMetrics{false};
+    // Events kept by TLoop::GetTrace, ignored unless built with UVEXEC_ENABLE_TRACING
+    std::size_t TraceCapacity{1 << 16};
+    // Max amount of operations scheduled from other threads and not applied yet, zero means unbounded.
+    // Over the mark schedule senders started outside the loop thread complete with set_stopped
+    std::size_t HighWaterMark{0};
+};
+
 class TLoop {
+    friend class TTraceSpan;
+
+    // Priority lanes, the idle one isn't counted
+    static constexpr std::size_t PrioritiesCount = 3;
+    static_assert(static_cast<std::size_t>(EPriority::Idle) == PrioritiesCount);
+
 public:
     struct TOperation {
         virtual void Apply() noexcept = 0;
 
-        TOperation* Next{nullptr};
+        std::atomic<TOperation*> Next{nullptr};
     };
 
+    // Intrusive MPSC queue: producers never retry, the only consumer is the thread running the loop
     class TOperationList {
     public:
         TOperationList() noexcept;
+        TOperationList(TOperationList&&) noexcept = delete;
+
+        void PushBack(TOperation& op) noexcept;
+        // Appends a chain already linked through TOperation::Next with a single atomic exchange
+        void PushBack(TOperation& first, TOperation& last) noexcept;
+        // May spuriously return nullptr while a producer is in the middle of PushBack,
+        // such a producer always wakes up the loop afterward
+        auto PopFront() noexcept -> TOperation*;
+        auto Empty() const noexcept -> bool;
+
+    private:
+        struct TStub final : TOperation {
+            void Apply() noexcept override {}
+        };
+
+    private:
+        std::atomic<TOperation*> Tail;
+        TOperation* Head;
+        TStub Stub;
+    };
+
+    // Operations linked into per lane chains through TOperation::Next, not owned by any loop yet
+    class TOperationChains {
+    public:
+        void PushBack(TOperation& op, EPriority priority) noexcept;
+        // Schedules everything collected with one splice per lane and at most one wakeup
+        void Submit(TLoop& loop) noexcept;
+        // Collected operations that count towards the backlog once submitted, i.e. the non-idle ones
+        auto Pending() const noexcept -> std::size_t;
+
+    private:
+        struct TChain {
+            TOperation* First{nullptr};
+            TOperation* Last{nullptr};
+        };
+
+    private:
+        // Indexed by EPriority, the idle lane included
+        std::array<TChain, PrioritiesCount + 1> Chains{};
+        std::size_t Size{0};
+        std::size_t IdleSize{0};
+    };
+
+    // Collects operations and schedules them with one splice per lane and one wakeup when submitted or destroyed.
+    // Schedule senders of the loop join the batch only when started with its environment, e.g. when spawned into
+    // exec::async_scope with get_env(), anything else the thread schedules meanwhile goes to the loop as usual.
+    // The batch is open until submitted, it must be submitted and destroyed by the thread that created it
+    class TScheduleBatch {
+    public:
+        class TEnv;
+
+        explicit TScheduleBatch(TLoop& loop) noexcept;
+        TScheduleBatch(TScheduleBatch&&) noexcept = delete;
+        ~TScheduleBatch();
+
+        void PushBack(TOperation& op, EPriority priority = EPriority::Normal) noexcept;
+        // Same as PushBack, but refuses the operation if the loop backlog together with the collected operations is
+        // over TLoopOptions::HighWaterMark, see TLoop::TrySchedule
+        auto TryPushBack(TOperation& op, EPriority priority = EPriority::Normal) noexcept -> bool;
+        void Submit() noexcept;
+        auto GetLoop() const noexcept -> TLoop&;
+        // Same as TScheduler::TLoopEnv, it also answers uvexec::get_schedule_batch with this batch, but only on the
+        // thread that created it and while it is open. Senders started later in the same chain, e.g. on the loop
+        // thread or after the batch is gone, get nullptr and schedule to the loop directly
+        auto get_env() noexcept -> TEnv;
+
+    private:
+        void Close() noexcept;
+
+    private:
+        TLoop* Loop;
+        TOperationChains Operations;
+        // Previous open batch of the creating thread
+        TScheduleBatch* Prev;
+        bool Open;
+    };
+
+    // Fired when the loop notices the expiry of TLoopTimer: in the poll phase on Linux, so operations transferred by
+    // timers are flushed by the check phase of the same iteration, in the timers phase elsewhere. See StartTimer,
+    // the deadline is kept in microseconds of TLoopClock
+    using TTimer = TTimerWheel::TTimer;
+
+    // Applied by the loop in the order of deadlines, see ScheduleByDeadline
+    struct TDeadlineOperation : TOperation {
+        virtual void ApplyOrdered() noexcept = 0;
+
+        TLoopClock::time_point Deadline{TLoopClock::time_point::max()};
+        std::uint64_t Seq{0};
+        TDeadlineOperation* Child{nullptr};
+        TDeadlineOperation* Sibling{nullptr};
+    };
+
+    // Intrusive pairing heap, earliest deadline first and FIFO among equal deadlines
+    class TDeadlineHeap {
+    public:
+        void Push(TDeadlineOperation& op) noexcept;
+        auto Pop() noexcept -> TDeadlineOperation*;
+        auto Empty() const noexcept -> bool;
+
+    private:
+        static auto Meld(TDeadlineOperation* lhs, TDeadlineOperation* rhs) noexcept -> TDeadlineOperation*;
+        static auto MeldPairs(TDeadlineOperation* first) noexcept -> TDeadlineOperation*;
+
+    private:
+        TDeadlineOperation* Root{nullptr};
+        std::uint64_t Seq{0};
+    };
+
+    // Plain FIFO for operations scheduled by the thread running the loop
+    class TLocalOperationList {
+    public:
         void PushBack(TOperation& op) noexcept;
-        auto Grab() noexcept -> TOperation*;
+        // Moves all operations of other to the back of this list
+        void Splice(TLocalOperationList& other) noexcept;
+        auto PopFront() noexcept -> TOperation*;
+        auto Empty() const noexcept -> bool;
 
     private:
-        std::atomic<TOperation*> Head;
+        TOperation* Head{nullptr};
+        TOperation* Tail{nullptr};
     };
 
     template <typename TOpState, stdexec::stoppable_token TStopToken>
@@ -122,6 +279,7 @@ public:
     };
 
     class TScheduler;
+    class TDeadlineScheduler;
 
     struct TDomain {
         template <stdexec::sender TSender>
@@ -147,31 +305,40 @@ public:
         template <stdexec::sender TSender, typename... TArgs>
         auto apply_sender(stdexec::sync_wait_t, TSender&& s, TArgs&&...) const {
             auto compSch = stdexec::get_completion_scheduler<stdexec::set_value_t>(stdexec::get_env(s));
-            return stdexec::tag_invoke(stdexec::sync_wait_t{}, compSch, std::forward<TSender>(s));
+            if constexpr (std::same_as<decltype(compSch), TDeadlineScheduler>) {
+                // Deadline ordered operations are applied by the same loop
+                return stdexec::tag_invoke(stdexec::sync_wait_t{}, GetLoop(compSch).get_scheduler(),
+                        std::forward<TSender>(s));
+            } else {
+                return stdexec::tag_invoke(stdexec::sync_wait_t{}, compSch, std::forward<TSender>(s));
+            }
         }
 
         auto GetLoop(const TScheduler& sch) const noexcept -> TLoop&;
+        auto GetLoop(const TDeadlineScheduler& sch) const noexcept -> TLoop&;
+        auto GetPriority(const TScheduler& sch) const noexcept -> EPriority;
     };
 
     class TScheduler {
         friend struct TLoop::TDomain;
 
     public:
-        explicit TScheduler(TLoop& loop) noexcept;
+        explicit TScheduler(TLoop& loop, EPriority priority = EPriority::Normal) noexcept;
 
         class TEnv {
         public:
-            explicit TEnv(TLoop& loop) noexcept;
+            explicit TEnv(TLoop& loop, EPriority priority = EPriority::Normal) noexcept;
 
             template <typename T>
             friend auto tag_invoke(stdexec::get_completion_scheduler_t<T>, const TEnv& env) noexcept -> TScheduler {
-                return env.Loop->get_scheduler();
+                return env.Loop->get_scheduler(env.Priority);
             }
 
             friend auto tag_invoke(stdexec::get_domain_t, const TEnv& env) noexcept -> TDomain;
 
         private:
             TLoop* Loop;
+            EPriority Priority;
         };
 
         friend auto tag_invoke(stdexec::get_domain_t, const TScheduler& s) noexcept -> TDomain;
@@ -183,6 +350,9 @@ public:
 
             friend auto tag_invoke(stdexec::get_scheduler_t, const TLoopEnv& env) noexcept -> TScheduler;
             friend auto tag_invoke(stdexec::get_domain_t, const TLoopEnv& env) noexcept -> TDomain;
+            // Operation states allocated with it, e.g. by uvexec::spawn, come from the loop slabs
+            friend auto tag_invoke(stdexec::get_allocator_t, const TLoopEnv& env) noexcept
+                    -> TLoopAllocator<std::byte>;
 
         private:
             TLoop* Loop;
@@ -216,39 +386,171 @@ public:
 
         auto operator==(const TScheduler&) const noexcept -> bool = default;
 
+    private:
+        TLoop* Loop;
+        EPriority Priority;
+    };
+
+    // Orders operations that are ready within one loop iteration by uvexec::get_deadline of their receivers,
+    // operations which deadline has already passed complete with set_stopped instead
+    class TDeadlineScheduler {
+        friend struct TLoop::TDomain;
+
+    public:
+        explicit TDeadlineScheduler(TLoop& loop) noexcept;
+
+        class TEnv {
+        public:
+            explicit TEnv(TLoop& loop) noexcept;
+
+            template <typename T>
+            friend auto tag_invoke(stdexec::get_completion_scheduler_t<T>, const TEnv& env) noexcept
+                    -> TDeadlineScheduler {
+                return env.Loop->get_deadline_scheduler();
+            }
+
+            friend auto tag_invoke(stdexec::get_domain_t, const TEnv& env) noexcept -> TDomain;
+
+        private:
+            TLoop* Loop;
+        };
+
+        friend auto tag_invoke(stdexec::get_domain_t, const TDeadlineScheduler& s) noexcept -> TDomain;
+        friend auto tag_invoke(exec::now_t, const TDeadlineScheduler& s) noexcept
+                -> std::chrono::time_point<TLoopClock>;
+
+        friend auto tag_invoke(stdexec::get_forward_progress_guarantee_t, const TDeadlineScheduler&) noexcept {
+            return stdexec::forward_progress_guarantee::parallel;
+        }
+
+        auto operator==(const TDeadlineScheduler&) const noexcept -> bool = default;
+
     private:
         TLoop* Loop;
     };
 
-    TLoop();
+    explicit TLoop(const TLoopOptions& options = {});
     TLoop(TLoop&&) noexcept = delete;
     ~TLoop();
 
-    auto get_scheduler() noexcept -> TScheduler;
+    auto get_scheduler(EPriority priority = EPriority::Normal) noexcept -> TScheduler;
+    // Same as get_scheduler(EPriority::Idle)
+    auto get_idle_scheduler() noexcept -> TScheduler;
+    auto get_deadline_scheduler() noexcept -> TDeadlineScheduler;
+    auto GetOptions() const noexcept -> const TLoopOptions&;
+    // Null unless TLoopOptions::CollectMetrics is set
+    auto GetMetrics() const noexcept -> const TLoopMetrics*;
+    // Null unless built with UVEXEC_ENABLE_TRACING
+    auto GetTrace() const noexcept -> const TTraceBuffer*;
+    // Serves TLoopAllocator and the frames of TTask coroutines, see TSlabAllocator
+    auto GetAllocator() noexcept -> TSlabAllocator&;
     auto run() -> bool;
     auto run_once() -> bool;
     auto drain() -> bool;
     void finish() noexcept;
 
-    void Schedule(TOperation& op) noexcept;
+    void Schedule(TOperation& op, EPriority priority = EPriority::Normal) noexcept;
+    // Same as Schedule, but when called by a thread running another loop, the operation is handed over at the end
+    // of that loop's current phase together with the rest of its operations for this loop, under a single wakeup
+    void Transfer(TOperation& op, EPriority priority = EPriority::Normal) noexcept;
+    // Same as Schedule, but refuses cross-thread operations while the backlog is over TLoopOptions::HighWaterMark
+    auto TrySchedule(TOperation& op, EPriority priority = EPriority::Normal) noexcept -> bool;
+    // Operations scheduled from other threads and not applied yet, tracked only with a high-water mark set
+    auto GetBacklog() const noexcept -> std::size_t;
+    // Must be called by the thread running the loop, op is applied after the current batch of operations
+    void ScheduleByDeadline(TDeadlineOperation& op) noexcept;
     void RunnerSteal(TRunner& runner);
+    // Both must be called by the thread running the loop. All the timers share a single TLoopTimer armed at the next
+    // expiry of the wheel, which ticks every microsecond. The timer may fire up to slack late, its deadline is rounded
+    // up to a multiple of the largest power of two not above slack, so that timers with close deadlines expire on the
+    // same tick
+    void StartTimer(TTimer& timer, TLoopClock::time_point deadline, TLoopClock::duration slack = {}) noexcept;
+    // Returns false if the timer has already fired or has never been started
+    auto StopTimer(TTimer& timer) noexcept -> bool;
+
+    // Loop run by the calling thread, null outside of any loop
+    static auto Current() noexcept -> TLoop*;
 
     friend auto tag_invoke(NUvUtil::TRawUvObject, TLoop& loop) noexcept -> uv_loop_t&;
     friend auto tag_invoke(NUvUtil::TRawUvObject, const TLoop& loop) noexcept -> const uv_loop_t&;
 
 private:
+    template <typename TOperationLists>
+    auto ApplyLanes(TOperationLists& lanes) noexcept -> std::size_t;
+
     void Walk(uv_walk_cb cb, void* arg);
-    auto RunLocked(std::unique_lock<std::mutex>& lock, uv_run_mode mode) -> bool;
+    auto Run(uv_run_mode mode) -> bool;
+    // Returns owning the loop with RunMtx unlocked, or false with RunMtx locked if the runner is finished first
+    auto AwaitLeadership(std::unique_lock<std::mutex>& lock, TRunner& runner) -> bool;
+    // Runs the owned loop and hands it over to the next runner in line, returns with RunMtx locked
+    auto RunLeading(std::unique_lock<std::mutex>& lock, TRunner& runner, uv_run_mode mode) -> bool;
+    auto RunSpinning(uv_run_mode mode) -> bool;
+    void StopSpinning() noexcept;
 
     static void ApplyOperations(uv_async_t* async);
+    static void ApplyLocalOperations(uv_check_t* check);
+    static void KeepPolling(uv_idle_t* idle);
+    static void BeforePoll(uv_prepare_t* prepare);
+    static void FireTimers(void* data);
+    static auto WheelTime(TLoopClock::time_point time) noexcept -> std::uint64_t;
+
+    void ArmTimer() noexcept;
+
+    void RecordIteration() noexcept;
+    void FlushOutbox() noexcept;
+
+    void RecordBatch(std::size_t applied) noexcept;
+
+    auto ApplyScheduled() noexcept -> std::size_t;
+    void Wakeup() noexcept;
 
 private:
+    TLoopOptions Options;
     uv_loop_t UvLoop;
     uv_async_t Async;
-    TOperationList Scheduled;
+    uv_check_t Check;
+    uv_idle_t Idle;
+    std::array<TOperationList, PrioritiesCount> Scheduled;
+    std::array<TLocalOperationList, PrioritiesCount> ScheduledLocal;
+    // Local operations the check phase applies, taken from ScheduledLocal before the loop polls. Same as with the
+    // async handle, an operation scheduled by a callback of the iteration is applied by the next one
+    std::array<TLocalOperationList, PrioritiesCount> ReadyLocal;
+    TOperationList ScheduledIdle;
+    std::uint64_t LastPolledEvents{0};
+    TDeadlineHeap ScheduledByDeadline;
+    TTimerWheel Timers;
+    TLoopTimer WheelTimer;
+    std::uint64_t ArmedAt{TTimerWheel::Never};
+    std::unique_ptr<TLoopMetrics> Metrics;
+    std::unique_ptr<TTraceBuffer> Trace;
+    TSlabAllocator Allocator;
+    uv_prepare_t Prepare;
+    // Operations transferred by this loop to other ones during the current phase, reserved up front and never grown
+    std::vector<std::pair<TLoop*, TOperationChains>> Outbox;
+    bool OutboxPending{false};
+    std::uint64_t LastPrepareTime{0};
+    std::uint64_t LastIdleTime{0};
+    std::atomic_size_t Backlog;
+    std::atomic_bool WakeupPending;
+    std::atomic_bool Spinning;
+    std::atomic_bool StopRequested;
     std::mutex RunMtx;
     TRunnersQueue Runners;
     bool Running;
 };
 
+class TLoop::TScheduleBatch::TEnv : public TLoop::TScheduler::TLoopEnv {
+public:
+    explicit TEnv(TScheduleBatch& batch) noexcept;
+
+    friend auto tag_invoke(uvexec::get_schedule_batch_t, const TEnv& env) noexcept -> TScheduleBatch*;
+
+private:
+    // Batch is only looked up among the open batches of the current thread, it may be dangling otherwise
+    auto Lookup() const noexcept -> TScheduleBatch*;
+
+private:
+    TScheduleBatch* Batch;
+};
+
 }
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2024 Michael Guzov
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+
+namespace NUvExec {
+
+class TLoop;
+
+// Size-class slab allocator of one loop, only the thread running the loop allocates from it. Blocks may be freed
+// by any thread, the ones freed by other threads are handed back lock-free and reused by the next allocation.
+// Every block is prefixed with its owner, so blocks of different loops and of the heap may be mixed freely.
+// Slabs are owned by the allocator, every block has to be freed before it's destroyed, the loop panics otherwise
+class TSlabAllocator {
+public:
+    // Alignment of every block, over-aligned types have to be allocated elsewhere
+    static constexpr std::size_t Alignment = 16;
+
+    TSlabAllocator() noexcept = default;
+    TSlabAllocator(TSlabAllocator&&) noexcept = delete;
+    ~TSlabAllocator();
+
+    // Must be called by the thread running the owning loop
+    auto Allocate(std::size_t size) -> void*;
+    // Heap block that may be passed to Deallocate
+    static auto AllocateUnpooled(std::size_t size) -> void*;
+    static void Deallocate(void* ptr) noexcept;
+
+    // Slab blocks allocated and not freed yet, may be read by any thread
+    auto GetLiveBlocks() const noexcept -> std::size_t;
+
+private:
+    static constexpr std::array<std::size_t, 16> ClassSizes{
+            32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024, 1536, 2048, 3072, 4096, 6144};
+    static constexpr std::size_t SlabSize = 64 * 1024;
+
+    struct alignas(Alignment) THeader {
+        TSlabAllocator* Owner;
+        std::size_t Class;
+    };
+
+    struct TBlock {
+        TBlock* Next;
+    };
+
+    struct TSizeClass {
+        TBlock* Free{nullptr};
+        std::byte* Cursor{nullptr};
+        std::byte* End{nullptr};
+        std::atomic<TBlock*> RemoteFree{nullptr};
+    };
+
+    static auto ClassOf(std::size_t size) noexcept -> std::size_t;
+
+    auto Refill(std::size_t cls) -> void*;
+    void DeallocateLocal(THeader& header) noexcept;
+    void DeallocateRemote(THeader& header) noexcept;
+
+private:
+    std::array<TSizeClass, ClassSizes.size()> Classes;
+    std::vector<std::unique_ptr<std::byte[]>> Slabs;
+    std::atomic<std::size_t> LiveBlocks{0};
+};
+
+// Allocates from the loop slabs when called by the thread running the loop, from the heap otherwise
+auto AllocateOnLoop(TLoop* loop, std::size_t size) -> void*;
+
+// Standard allocator over TSlabAllocator, see TLoop::TScheduler::TLoopEnv.
+// Memory allocated by the loop thread must be deallocated before the loop is destroyed: coroutine frames, spawned
+// operations and the like must not outlive it
+template <typename T>
+class TLoopAllocator {
+    template <typename U>
+    friend class TLoopAllocator;
+
+public:
+    using value_type = T;
+
+    explicit TLoopAllocator(TLoop& loop) noexcept
+        : Loop{&loop}
+    {}
+
+    template <typename U>
+    TLoopAllocator(const TLoopAllocator<U>& other) noexcept
+        : Loop{other.Loop}
+    {}
+
+    auto allocate(std::size_t n) -> T* {
+        if constexpr (alignof(T) > TSlabAllocator::Alignment) {
+            return std::allocator<T>().allocate(n);
+        } else {
+            return static_cast<T*>(AllocateOnLoop(Loop, n * sizeof(T)));
+        }
+    }
+
+    void deallocate(T* ptr, std::size_t n) noexcept {
+        if constexpr (alignof(T) > TSlabAllocator::Alignment) {
+            std::allocator<T>().deallocate(ptr, n);
+        } else {
+            TSlabAllocator::Deallocate(ptr);
+        }
+    }
+
+    template <typename U>
+    auto operator==(const TLoopAllocator<U>& other) const noexcept -> bool {
+        return Loop == other.Loop;
+    }
+
+private:
+    TLoop* Loop;
+};
+
+}
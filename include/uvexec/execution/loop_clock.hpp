@@ -20,14 +20,15 @@
 
 namespace NUvExec {
 
+// Monotonic clock of uv_hrtime, the same one for all the loops, exec::now of their schedulers reads it too
 struct TLoopClock {
-    using rep = std::chrono::milliseconds::rep;
-    using period = std::chrono::milliseconds::period;
-    using duration = std::chrono::milliseconds;
+    using rep = std::chrono::nanoseconds::rep;
+    using period = std::chrono::nanoseconds::period;
+    using duration = std::chrono::nanoseconds;
     using time_point = std::chrono::time_point<TLoopClock, duration>;
 
     static constexpr bool is_steady = true;
-    static time_point now() noexcept; // Non-static, use exec::now(uvLoop.get_scheduler()) instead
+    static time_point now() noexcept;
 };
 
 }
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2024 Michael Guzov
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+
+namespace NUvExec {
+
+// Lock-free histogram with power of two buckets: bucket 0 counts zeros, bucket i counts values in [2^(i-1), 2^i)
+class TLog2Histogram {
+public:
+    static constexpr std::size_t BucketsCount = 65;
+
+    void Record(std::uint64_t value) noexcept;
+
+    auto Count() const noexcept -> std::uint64_t;
+    auto Sum() const noexcept -> std::uint64_t;
+    auto Bucket(std::size_t idx) const noexcept -> std::uint64_t;
+    // Upper bound of the bucket holding the given quantile, quantile is in [0, 1]
+    auto Quantile(double quantile) const noexcept -> std::uint64_t;
+
+private:
+    std::array<std::atomic_uint64_t, BucketsCount> Buckets{};
+    std::atomic_uint64_t Total{0};
+};
+
+// Updated by the loop and its producers with relaxed atomics, so any thread may read it while the loop runs
+struct TLoopMetrics {
+    // Operations passed to TLoop::Schedule and ScheduleByDeadline
+    std::atomic_uint64_t Scheduled{0};
+    std::atomic_uint64_t Applied{0};
+    // Operations refused by TLoop::TrySchedule over the high-water mark
+    std::atomic_uint64_t Rejected{0};
+    std::atomic_uint64_t Iterations{0};
+    // Time spent blocked in poll, see UV_METRICS_IDLE_TIME
+    std::atomic_uint64_t IdleTimeNs{0};
+    // Wakeups of the timer shared by the loop timers, each one expires all the timers due by then
+    std::atomic_uint64_t TimerTicks{0};
+    // As seen by libuv, including the handles owned by the loop itself
+    std::atomic_uint64_t ActiveHandles{0};
+    // Operations applied by one drain of the run queues
+    TLog2Histogram BatchSizes;
+    // Iteration time excluding the time spent blocked in poll
+    TLog2Histogram IterationTimesNs;
+
+    auto QueueDepth() const noexcept -> std::uint64_t;
+    auto IdleTime() const noexcept -> std::chrono::nanoseconds;
+};
+
+}
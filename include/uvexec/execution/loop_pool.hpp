@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2024 Michael Guzov
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "loop.hpp"
+#include "steal_deque.hpp"
+
+#include <algorithm>
+#include <latch>
+#include <memory>
+#include <thread>
+#include <vector>
+
+
+namespace NUvExec {
+
+enum class EBalancing {
+    RoundRobin,
+    LeastLoaded,
+    WorkStealing // Operations aren't bound to a loop and may be stolen by an idle one
+};
+
+struct TLoopPoolOptions {
+    std::size_t Size{std::max(std::thread::hardware_concurrency(), 1u)};
+    // CPU sets the threads are pinned to, thread i gets Affinity[i % Affinity.size()]. Threads float if empty.
+    // Every loop is created by its own thread after pinning, so its memory is first touched on the local NUMA node
+    std::vector<std::vector<std::size_t>> Affinity;
+};
+
+// Owns a fixed set of loops, each one driven by its own thread
+class TLoopPool {
+public:
+    class TScheduler;
+
+    struct TDomain {
+        template <stdexec::sender TSender, typename... TArgs>
+        auto apply_sender(stdexec::sync_wait_t, TSender&& s, TArgs&&...) const {
+            auto compSch = stdexec::get_completion_scheduler<stdexec::set_value_t>(stdexec::get_env(s));
+            return stdexec::tag_invoke(stdexec::sync_wait_t{}, compSch, std::forward<TSender>(s));
+        }
+
+        auto GetPool(const TScheduler& sch) const noexcept -> TLoopPool&;
+        auto GetBalancing(const TScheduler& sch) const noexcept -> EBalancing;
+    };
+
+    class TScheduler {
+        friend struct TLoopPool::TDomain;
+
+    public:
+        TScheduler(TLoopPool& pool, EBalancing balancing) noexcept;
+
+        class TEnv {
+        public:
+            TEnv(TLoopPool& pool, EBalancing balancing) noexcept;
+
+            template <typename T>
+            friend auto tag_invoke(stdexec::get_completion_scheduler_t<T>, const TEnv& env) noexcept -> TScheduler {
+                return env.Pool->get_scheduler(env.Balancing);
+            }
+
+            friend auto tag_invoke(stdexec::get_domain_t, const TEnv& env) noexcept -> TDomain;
+
+        private:
+            TLoopPool* Pool;
+            EBalancing Balancing;
+        };
+
+        friend auto tag_invoke(stdexec::get_domain_t, const TScheduler& s) noexcept -> TDomain;
+
+        class TPoolEnv {
+        public:
+            TPoolEnv(TLoopPool& pool, EBalancing balancing) noexcept;
+
+            friend auto tag_invoke(stdexec::get_scheduler_t, const TPoolEnv& env) noexcept -> TScheduler;
+            friend auto tag_invoke(stdexec::get_domain_t, const TPoolEnv& env) noexcept -> TDomain;
+
+        private:
+            TLoopPool* Pool;
+            EBalancing Balancing;
+        };
+
+        // Pool loops are driven by their own threads, so the caller just blocks until completion
+        template <stdexec::sender_in<TPoolEnv> TS>
+        friend auto tag_invoke(stdexec::sync_wait_t, const TScheduler& sched, TS&& sender) {
+            TRunner runner;
+            auto wakeup = [&runner]() noexcept {
+                runner.Finish();
+            };
+
+            using TWakeup = decltype(wakeup);
+            using TWaitR = TSyncWaitReceiver<TPoolEnv, TS, TWakeup>;
+
+            TPoolEnv env(*sched.Pool, sched.Balancing);
+            TSyncWaitReceiverState<TPoolEnv, TS, TWakeup> dest;
+            auto op = stdexec::connect(std::forward<TS>(sender), TWaitR(dest, env, std::move(wakeup)));
+            stdexec::start(op);
+            while (!runner.Finished()) {
+                runner.Wait();
+            }
+            return UnwrapSyncWaitReceiverState<TPoolEnv, TS, TWakeup>(std::move(dest));
+        }
+
+        friend auto tag_invoke(stdexec::get_forward_progress_guarantee_t, const TScheduler&) noexcept {
+            return stdexec::forward_progress_guarantee::parallel;
+        }
+
+        auto operator==(const TScheduler&) const noexcept -> bool = default;
+
+    private:
+        TLoopPool* Pool;
+        EBalancing Balancing;
+    };
+
+    explicit TLoopPool(std::size_t size = std::max(std::thread::hardware_concurrency(), 1u));
+    explicit TLoopPool(const TLoopPoolOptions& options);
+    TLoopPool(TLoopPool&&) noexcept = delete;
+    ~TLoopPool();
+
+    auto get_scheduler(EBalancing balancing = EBalancing::RoundRobin) noexcept -> TScheduler;
+    auto get_scheduler(std::size_t idx) noexcept -> TLoop::TScheduler;
+    auto size() const noexcept -> std::size_t;
+
+    auto Loop(std::size_t idx) noexcept -> TLoop&;
+
+    auto Pick(EBalancing balancing) noexcept -> std::size_t;
+    void Schedule(std::size_t idx, TLoop::TOperation& op, EBalancing balancing) noexcept;
+    void Release(std::size_t idx) noexcept;
+    // Stealable operations still queued when the pool is destroyed are applied after this is set, see Stop
+    auto Stopped() const noexcept -> bool;
+
+private:
+    // Amount of stealable operations applied by one drain before yielding to I/O
+    static constexpr std::size_t DrainBudget = 64;
+
+    struct TWorker;
+
+    class TFinishOperation final : public TLoop::TOperation {
+    public:
+        explicit TFinishOperation(TWorker& worker) noexcept;
+
+        void Apply() noexcept override;
+
+    private:
+        TWorker* Worker;
+    };
+
+    class TDrainOperation final : public TLoop::TOperation {
+    public:
+        TDrainOperation(TLoopPool& pool, std::size_t idx) noexcept;
+
+        void Apply() noexcept override;
+
+    private:
+        TLoopPool* Pool;
+        std::size_t Idx;
+    };
+
+    struct TWorker {
+        TWorker(TLoopPool& pool, std::size_t idx);
+
+        TLoop Loop;
+        TRunner Runner;
+        TFinishOperation Finish;
+        TDrainOperation Drain;
+        std::atomic_size_t Load;
+        // Stealable operations pushed by other threads, consumed by the worker once its deque is empty and by
+        // thieves once the deque of the worker is
+        TStealRing Inbox;
+        TStealDeque Queue;
+        std::atomic_bool DrainScheduled;
+        std::atomic_bool Idle;
+    };
+
+    void Work(std::size_t idx, const TLoopPoolOptions& options, std::latch& started, NUvUtil::TUvError& err);
+    void Stop() noexcept;
+
+    void Push(std::size_t idx, TLoop::TOperation& op) noexcept;
+    auto Pop(std::size_t idx) noexcept -> TLoop::TOperation*;
+    auto Steal(std::size_t thief) noexcept -> TLoop::TOperation*;
+    auto HasStealable(std::size_t thief) const noexcept -> bool;
+    void WakeupIdle(std::size_t busy) noexcept;
+    void ScheduleDrain(std::size_t idx) noexcept;
+    void ApplyStealable(std::size_t idx) noexcept;
+
+private:
+    std::vector<std::unique_ptr<TWorker>> Workers;
+    std::vector<std::thread> Threads;
+    std::atomic_size_t Next;
+    // Worker threads are joined, only the thread stopping the pool touches the workers
+    bool Joined;
+};
+
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2024 Michael Guzov
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "loop_clock.hpp"
+#include <uvexec/uv_util/errors.hpp>
+
+#include <uv.h>
+
+
+namespace NUvExec {
+
+// One-shot timer armed at an absolute deadline of TLoopClock. On Linux it is a timerfd polled by the loop, so the
+// deadline is honored with a sub-millisecond resolution, elsewhere it falls back to a uv timer rounded up to
+// milliseconds. Owned by the thread running the loop, must be closed before the loop
+class TLoopTimer {
+public:
+    using TCallback = void (*)(void* data);
+
+    TLoopTimer() noexcept = default;
+    TLoopTimer(TLoopTimer&&) noexcept = delete;
+
+    auto Init(uv_loop_t& loop, TCallback callback, void* data) -> NUvUtil::TUvError;
+    // Rearms the timer if it's already started, a deadline in the past fires it on the next iteration
+    auto Start(TLoopClock::time_point deadline) -> NUvUtil::TUvError;
+    void Stop() noexcept;
+    void Close() noexcept;
+
+private:
+#ifdef __linux__
+    static void OnReadable(uv_poll_t* poll, int status, int events);
+#else
+    static void OnTimeout(uv_timer_t* timer);
+#endif
+
+private:
+    TCallback Callback{nullptr};
+    void* Data{nullptr};
+#ifdef __linux__
+    uv_poll_t Poll;
+    int Fd{-1};
+#else
+    uv_timer_t Timer;
+#endif
+};
+
+}
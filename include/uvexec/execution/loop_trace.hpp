@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2024 Michael Guzov
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <uv.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <span>
+#include <vector>
+
+
+namespace NUvExec {
+
+struct TTraceEvent {
+    const char* Name;
+    std::uint64_t BeginNs;
+    std::uint64_t EndNs;
+    std::uint64_t ThreadId;
+};
+
+// Fixed size ring of events overwriting the oldest ones, writers never block and readers skip slots being rewritten
+class TTraceBuffer {
+public:
+    // Capacity is rounded up to a power of two
+    explicit TTraceBuffer(std::size_t capacity);
+
+    void Record(const TTraceEvent& event) noexcept;
+    // Events currently kept in the buffer, oldest first
+    auto Snapshot() const -> std::vector<TTraceEvent>;
+    auto Id() const noexcept -> std::uint64_t;
+
+private:
+    // Seqlock: odd sequence while the slot is being written
+    struct TSlot {
+        std::atomic_uint64_t Seq{0};
+        std::atomic<const char*> Name{nullptr};
+        std::atomic_uint64_t BeginNs{0};
+        std::atomic_uint64_t EndNs{0};
+        std::atomic_uint64_t ThreadId{0};
+    };
+
+private:
+    std::unique_ptr<TSlot[]> Slots;
+    std::size_t Mask;
+    std::atomic_uint64_t Head;
+    std::uint64_t BufferId;
+};
+
+// Chrome trace event format, loads into chrome://tracing and Perfetto. Every buffer is shown as a process
+void WriteChromeTrace(std::ostream& out, std::span<const TTraceBuffer* const> traces);
+
+// Lifetime of an operation recorded into the trace of its loop, compiles to nothing unless UVEXEC_ENABLE_TRACING is set
+class TTraceSpan {
+public:
+#ifdef UVEXEC_ENABLE_TRACING
+    void Begin(uv_loop_t& loop, const char* name) noexcept;
+    void End() noexcept;
+
+private:
+    TTraceBuffer* Buffer{nullptr};
+    const char* Name{nullptr};
+    std::uint64_t BeginNs{0};
+#else
+    void Begin(uv_loop_t&, const char*) noexcept {}
+    void End() noexcept {}
+#endif
+};
+
+}
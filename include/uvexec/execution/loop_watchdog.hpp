@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2024 Michael Guzov
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "loop.hpp"
+#include "loop_metrics.hpp"
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+
+namespace NUvExec {
+
+struct TLoopWatchdogOptions {
+    // How often the loop is probed, also the granularity of stall detection
+    std::chrono::nanoseconds ProbePeriod{std::chrono::milliseconds(100)};
+    // A probe the loop hasn't picked up for this long means the loop is stuck inside an iteration
+    std::chrono::nanoseconds StallThreshold{std::chrono::seconds(1)};
+    // Called on the watchdog thread once per stall with the time the loop has been stuck so far
+    std::function<void(TLoop&, std::chrono::nanoseconds)> OnStall;
+};
+
+// Periodically schedules a probe on the loop from its own thread: the delay until the probe is applied is the loop lag,
+// a probe pending for longer than the threshold is reported as a stall. The loop is expected to be driven all the time,
+// at least until the watchdog is destroyed: the destructor waits for the probe in flight to be applied, so it must not
+// be called by the thread running the loop
+class TLoopWatchdog {
+public:
+    TLoopWatchdog(TLoop& loop, TLoopWatchdogOptions options);
+    TLoopWatchdog(TLoopWatchdog&&) noexcept = delete;
+    ~TLoopWatchdog();
+
+    auto GetLags() const noexcept -> const TLog2Histogram&;
+    auto GetLastLag() const noexcept -> std::chrono::nanoseconds;
+    auto GetStallsCount() const noexcept -> std::uint64_t;
+
+private:
+    using TClock = std::chrono::steady_clock;
+
+    struct TProbe final : TLoop::TOperation {
+        explicit TProbe(TLoopWatchdog& watchdog) noexcept;
+
+        void Apply() noexcept override;
+
+        TLoopWatchdog* Watchdog;
+        TLog2Histogram LagsNs;
+        std::atomic<std::chrono::nanoseconds::rep> LastLagNs{0};
+        std::atomic<TClock::rep> SentAt{0};
+        std::atomic_bool Pending{false};
+    };
+
+    void Watch();
+
+private:
+    TLoop* Loop;
+    TLoopWatchdogOptions Options;
+    TProbe Probe;
+    std::atomic_uint64_t Stalls;
+    bool StallReported;
+    std::mutex Mtx;
+    std::condition_variable StopCv;
+    std::condition_variable ProbeCv;
+    bool Stopped;
+    std::thread Thread;
+};
+
+}
@@ -36,8 +36,14 @@ public:
 
     void Wait() noexcept;
 
+    // Makes the runner the loop leader without releasing the loop in between
+    void Promote() noexcept;
+
+    bool TakePromotion() noexcept;
+
 private:
     std::atomic_uint64_t Awakenings{1};
+    std::atomic_bool Promoted{false};
     bool Acq{false};
 };
 
@@ -49,7 +55,7 @@ public:
 
     void Erase(TRunner& runner);
 
-    void WakeupNext() noexcept;
+    bool PromoteNext() noexcept;
 
 private:
     TIntrusiveList<TRunner> Runners;
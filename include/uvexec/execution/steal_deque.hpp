@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2024 Michael Guzov
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "loop.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace NUvExec {
+
+// Bounded Chase-Lev deque of operations. Only its owner pushes and pops, at the bottom, so the most recently pushed
+// operation, which is likely still in cache, runs first. Any thread may steal the oldest one from the top.
+// Neither end locks nor allocates, the ring is preallocated and Push fails once it's full
+class TStealDeque {
+public:
+    static constexpr std::size_t Capacity = 1024;
+
+    TStealDeque() noexcept = default;
+    TStealDeque(TStealDeque&&) noexcept = delete;
+
+    // Owner only
+    auto Push(TLoop::TOperation& op) noexcept -> bool;
+    // Owner only
+    auto Pop() noexcept -> TLoop::TOperation*;
+    // May spuriously return nullptr when racing with another thief or with the owner for the last operation
+    auto Steal() noexcept -> TLoop::TOperation*;
+    // Exact for the owner, a snapshot for others
+    auto Size() const noexcept -> std::size_t;
+    auto Empty() const noexcept -> bool;
+
+private:
+    static constexpr std::int64_t Mask = Capacity - 1;
+    static_assert((Capacity & (Capacity - 1)) == 0);
+
+private:
+    alignas(64) std::atomic<std::int64_t> Top{0};
+    alignas(64) std::atomic<std::int64_t> Bottom{0};
+    alignas(64) std::array<std::atomic<TLoop::TOperation*>, Capacity> Ring{};
+};
+
+// Bounded FIFO ring of operations any thread may push to and steal from, the inbox of a worker for the operations
+// of other threads. Slots carry sequence numbers, so neither end locks nor allocates, Push fails once it's full
+class TStealRing {
+public:
+    static constexpr std::size_t Capacity = 1024;
+
+    TStealRing() noexcept;
+    TStealRing(TStealRing&&) noexcept = delete;
+
+    auto Push(TLoop::TOperation& op) noexcept -> bool;
+    // May spuriously return nullptr while a producer is in the middle of Push
+    auto Steal() noexcept -> TLoop::TOperation*;
+    // Snapshot, a slot being pushed counts as taken
+    auto Empty() const noexcept -> bool;
+
+private:
+    static constexpr std::size_t Mask = Capacity - 1;
+    static_assert((Capacity & (Capacity - 1)) == 0);
+
+    struct TSlot {
+        std::atomic<std::size_t> Seq;
+        TLoop::TOperation* Op{nullptr};
+    };
+
+private:
+    alignas(64) std::atomic<std::size_t> Head{0};
+    alignas(64) std::atomic<std::size_t> Tail{0};
+    alignas(64) std::array<TSlot, Capacity> Slots;
+};
+
+}
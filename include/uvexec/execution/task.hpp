@@ -0,0 +1,452 @@
+/*
+ * Copyright (c) 2024 Michael Guzov
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "loop.hpp"
+
+#include <uvexec/meta/meta.hpp>
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <variant>
+
+
+namespace NUvExec {
+
+template <typename T = void>
+class TTask;
+
+namespace NDetail {
+
+// Completes the outermost task of a chain of awaiting tasks
+class TTaskRoot {
+public:
+    virtual void Complete() noexcept = 0;
+    virtual void Stop() noexcept = 0;
+
+protected:
+    ~TTaskRoot() = default;
+};
+
+template <typename... Ts>
+struct TAwaitResult {
+    using TType = std::tuple<Ts...>;
+};
+
+template <typename T>
+struct TAwaitResult<T> {
+    using TType = T;
+};
+
+template <>
+struct TAwaitResult<> {
+    using TType = void;
+};
+
+template <typename... Ts>
+using TAwaitResultOf = typename TAwaitResult<std::decay_t<Ts>...>::TType;
+
+// Awaited senders have to complete with a single set of values, if any
+template <typename... Ts>
+struct TSingleAwaitResult;
+
+template <typename T>
+struct TSingleAwaitResult<T> {
+    using TType = T;
+};
+
+template <>
+struct TSingleAwaitResult<> {
+    using TType = void;
+};
+
+template <typename... Ts>
+using TSingleAwaitResultOf = typename TSingleAwaitResult<Ts...>::TType;
+
+template <typename TError>
+auto AsExceptionPtr(TError&& err) noexcept -> std::exception_ptr {
+    if constexpr (std::same_as<std::decay_t<TError>, std::exception_ptr>) {
+        return std::forward<TError>(err);
+    } else if constexpr (std::constructible_from<std::error_code, TError>) {
+        return std::make_exception_ptr(std::system_error(err));
+    } else {
+        return std::make_exception_ptr(std::forward<TError>(err));
+    }
+}
+
+class TTaskPromiseBase;
+
+// Awaits a sender connected right in the coroutine frame. The coroutine is resumed inline when the sender completes
+// on the task loop, e.g. by TLoop::TScheduler, and is rescheduled onto the loop otherwise
+template <stdexec::sender_in<TLoop::TScheduler::TLoopEnv> TSender>
+class TSenderAwaiter final : public TLoop::TOperation {
+    using TEnv = TLoop::TScheduler::TLoopEnv;
+    using TResult = stdexec::value_types_of_t<TSender, TEnv, TAwaitResultOf, TSingleAwaitResultOf>;
+    using TValue = std::conditional_t<std::is_void_v<TResult>, std::monostate, TResult>;
+
+    class TReceiver final : public stdexec::receiver_adaptor<TReceiver> {
+        friend stdexec::receiver_adaptor<TReceiver>;
+
+    public:
+        explicit TReceiver(TSenderAwaiter& awaiter) noexcept
+            : Awaiter{&awaiter}
+        {}
+
+        template <typename... TArgs>
+        void set_value(TArgs&&... args) noexcept {
+            try {
+                Awaiter->Result.template emplace<1>(std::forward<TArgs>(args)...);
+            } catch (...) {
+                Awaiter->Result.template emplace<2>(std::current_exception());
+            }
+            Awaiter->Resume();
+        }
+
+        template <typename TError>
+        void set_error(TError&& err) noexcept {
+            Awaiter->Result.template emplace<2>(AsExceptionPtr(std::forward<TError>(err)));
+            Awaiter->Resume();
+        }
+
+        void set_stopped() noexcept {
+            Awaiter->Result.template emplace<3>();
+            Awaiter->Resume();
+        }
+
+        [[nodiscard]]
+        auto get_env() const noexcept -> TEnv {
+            return TEnv(*Awaiter->Loop);
+        }
+
+    private:
+        TSenderAwaiter* Awaiter;
+    };
+
+public:
+    TSenderAwaiter(TSender&& sender, TLoop& loop, TTaskRoot& root)
+        : Loop{&loop}
+        , Root{&root}
+        , Op(stdexec::connect(std::move(sender), TReceiver(*this)))
+    {}
+
+    TSenderAwaiter(TSenderAwaiter&&) = delete;
+
+    auto await_ready() const noexcept -> bool {
+        return false;
+    }
+
+    auto await_suspend(std::coroutine_handle<> handle) noexcept -> bool {
+        Handle = handle;
+        stdexec::start(Op);
+        if (!Done) {
+            Suspended = true;
+            return true;
+        }
+        if (Result.index() == 3) {
+            Root->Stop(); // Destroys the whole chain of tasks, this included
+            return true;
+        }
+        return false; // Completed synchronously, go on without growing the stack
+    }
+
+    auto await_resume() -> TResult {
+        if (Result.index() == 2) {
+            std::rethrow_exception(std::get<2>(std::move(Result)));
+        }
+        if constexpr (!std::is_void_v<TResult>) {
+            return std::get<1>(std::move(Result));
+        }
+    }
+
+    void Apply() noexcept override {
+        Continue();
+    }
+
+private:
+    void Resume() noexcept {
+        if (TLoop::Current() != Loop) {
+            Loop->Schedule(*this);
+        } else if (Suspended) {
+            Continue();
+        } else {
+            Done = true; // Still inside of await_suspend
+        }
+    }
+
+    void Continue() noexcept {
+        if (Result.index() == 3) {
+            Root->Stop();
+        } else {
+            Handle.resume();
+        }
+    }
+
+private:
+    using TOpState = stdexec::connect_result_t<TSender, TReceiver>;
+
+    TLoop* Loop;
+    TTaskRoot* Root;
+    std::variant<std::monostate, TValue, std::exception_ptr, stdexec::set_stopped_t> Result;
+    std::coroutine_handle<> Handle;
+    bool Suspended{false};
+    bool Done{false};
+    TOpState Op;
+};
+
+class TTaskPromiseBase {
+    template <typename T>
+    friend class NUvExec::TTask;
+
+public:
+    // Frames created on a loop thread come from the loop slabs
+    static auto operator new(std::size_t size) -> void* {
+        return AllocateOnLoop(TLoop::Current(), size);
+    }
+
+    static void operator delete(void* ptr) noexcept {
+        TSlabAllocator::Deallocate(ptr);
+    }
+
+    struct TFinalAwaiter {
+        auto await_ready() const noexcept -> bool {
+            return false;
+        }
+
+        template <std::derived_from<TTaskPromiseBase> TPromise>
+        auto await_suspend(std::coroutine_handle<TPromise> handle) noexcept -> std::coroutine_handle<> {
+            auto& promise = handle.promise();
+            if (promise.Continuation) {
+                return promise.Continuation; // Symmetric transfer to the awaiting task
+            }
+            promise.Root->Complete();
+            return std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    auto initial_suspend() const noexcept -> std::suspend_always {
+        return {};
+    }
+
+    auto final_suspend() const noexcept -> TFinalAwaiter {
+        return {};
+    }
+
+    void unhandled_exception() noexcept {
+        Exception = std::current_exception();
+    }
+
+    template <typename T>
+    auto await_transform(TTask<T>&& task) noexcept -> typename TTask<T>::TAwaiter {
+        return typename TTask<T>::TAwaiter(std::move(task));
+    }
+
+    template <stdexec::sender_in<TLoop::TScheduler::TLoopEnv> TSender>
+    auto await_transform(TSender&& sender) -> TSenderAwaiter<std::decay_t<TSender>> {
+        return TSenderAwaiter<std::decay_t<TSender>>(std::forward<TSender>(sender), *Loop, *Root);
+    }
+
+protected:
+    void Rethrow() const {
+        if (Exception) {
+            std::rethrow_exception(Exception);
+        }
+    }
+
+protected:
+    TLoop* Loop{nullptr};
+    TTaskRoot* Root{nullptr};
+    std::coroutine_handle<> Continuation;
+    std::exception_ptr Exception;
+};
+
+template <typename T>
+class TTaskPromise final : public TTaskPromiseBase {
+public:
+    auto get_return_object() noexcept -> TTask<T>;
+
+    template <typename TValue> requires std::constructible_from<T, TValue>
+    void return_value(TValue&& value) noexcept(std::is_nothrow_constructible_v<T, TValue>) {
+        Value.emplace(std::forward<TValue>(value));
+    }
+
+    auto Result() -> T {
+        Rethrow();
+        return *std::move(Value);
+    }
+
+private:
+    std::optional<T> Value;
+};
+
+template <>
+class TTaskPromise<void> final : public TTaskPromiseBase {
+public:
+    auto get_return_object() noexcept -> TTask<void>;
+
+    void return_void() const noexcept {}
+
+    void Result() const {
+        Rethrow();
+    }
+};
+
+template <typename T, stdexec::receiver TReceiver>
+class TTaskOpState final : public TLoop::TOperation, public TTaskRoot {
+    using TPromise = TTaskPromise<T>;
+
+public:
+    TTaskOpState(std::coroutine_handle<TPromise> handle, TReceiver&& rec) noexcept
+        : Handle{handle}, Receiver(std::move(rec))
+    {}
+
+    TTaskOpState(TTaskOpState&&) = delete;
+
+    ~TTaskOpState() {
+        Handle.destroy();
+    }
+
+    friend void tag_invoke(stdexec::start_t, TTaskOpState& op) noexcept {
+        auto& loop = TLoop::TDomain{}.GetLoop(stdexec::get_scheduler(stdexec::get_env(op.Receiver)));
+        op.Handle.promise().Loop = &loop;
+        op.Handle.promise().Root = &op;
+        if (TLoop::Current() == &loop) {
+            op.Handle.resume();
+        } else {
+            loop.Schedule(op);
+        }
+    }
+
+    void Apply() noexcept override {
+        Handle.resume();
+    }
+
+    void Complete() noexcept override {
+        try {
+            if constexpr (std::is_void_v<T>) {
+                Handle.promise().Result();
+                stdexec::set_value(std::move(Receiver));
+            } else {
+                stdexec::set_value(std::move(Receiver), Handle.promise().Result());
+            }
+        } catch (...) {
+            stdexec::set_error(std::move(Receiver), std::current_exception());
+        }
+    }
+
+    void Stop() noexcept override {
+        stdexec::set_stopped(std::move(Receiver));
+    }
+
+private:
+    std::coroutine_handle<TPromise> Handle;
+    TReceiver Receiver;
+};
+
+template <typename T>
+struct TTaskValueSignature {
+    using TType = stdexec::set_value_t(T);
+};
+
+template <>
+struct TTaskValueSignature<void> {
+    using TType = stdexec::set_value_t();
+};
+
+}
+
+// Lazy coroutine bound to the loop it is started on, it requires a TLoop scheduler in the receiver environment.
+// Awaited senders completing on the loop resume the coroutine inline, awaited tasks are resumed through symmetric
+// transfer, and frames are recycled by the loop. Stop requests of the receiver aren't forwarded to awaited senders
+template <typename T>
+class TTask {
+    friend class NDetail::TTaskPromise<T>;
+    friend class NDetail::TTaskPromiseBase;
+
+public:
+    using promise_type = NDetail::TTaskPromise<T>;
+    using sender_concept = stdexec::sender_t;
+    using completion_signatures = stdexec::completion_signatures<typename NDetail::TTaskValueSignature<T>::TType,
+            stdexec::set_error_t(std::exception_ptr), stdexec::set_stopped_t()>;
+
+    TTask(TTask&& task) noexcept
+        : Handle{std::exchange(task.Handle, {})}
+    {}
+
+    ~TTask() {
+        if (Handle) {
+            Handle.destroy();
+        }
+    }
+
+    template <stdexec::receiver TReceiver> requires std::same_as<TLoop::TScheduler,
+            std::invoke_result_t<stdexec::get_scheduler_t, stdexec::env_of_t<TReceiver>>>
+    friend auto tag_invoke(stdexec::connect_t, TTask&& task, TReceiver&& rec) {
+        return NDetail::TTaskOpState<T, std::decay_t<TReceiver>>(
+                std::exchange(task.Handle, {}), std::forward<TReceiver>(rec));
+    }
+
+private:
+    class TAwaiter {
+    public:
+        explicit TAwaiter(TTask&& task) noexcept
+            : Task(std::move(task))
+        {}
+
+        auto await_ready() const noexcept -> bool {
+            return false;
+        }
+
+        template <std::derived_from<NDetail::TTaskPromiseBase> TPromise>
+        auto await_suspend(std::coroutine_handle<TPromise> parent) noexcept -> std::coroutine_handle<> {
+            auto& promise = Task.Handle.promise();
+            promise.Loop = parent.promise().Loop;
+            promise.Root = parent.promise().Root;
+            promise.Continuation = parent;
+            return Task.Handle;
+        }
+
+        auto await_resume() -> T {
+            return Task.Handle.promise().Result();
+        }
+
+    private:
+        TTask Task;
+    };
+
+    explicit TTask(std::coroutine_handle<promise_type> handle) noexcept
+        : Handle{handle}
+    {}
+
+private:
+    std::coroutine_handle<promise_type> Handle;
+};
+
+template <typename T>
+auto NDetail::TTaskPromise<T>::get_return_object() noexcept -> TTask<T> {
+    return TTask<T>(std::coroutine_handle<TTaskPromise>::from_promise(*this));
+}
+
+inline auto NDetail::TTaskPromise<void>::get_return_object() noexcept -> TTask<void> {
+    return TTask<void>(std::coroutine_handle<TTaskPromise>::from_promise(*this));
+}
+
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2024 Michael Guzov
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <uvexec/util/intrusive_list.hpp>
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+
+namespace NUvExec {
+
+// Hierarchical timing wheel, owned and advanced by the thread running the loop. Level l has 64 slots of 64^l ticks,
+// a timer is kept at the lowest level which block it shares with the current time, so insert and cancel are O(1)
+// and each timer cascades to a lower level at most once per level. Deadlines beyond the top level wait in overflow
+class TTimerWheel {
+public:
+    struct TTimer : TIntrusiveListNode<TTimer> {
+        virtual void Fire() noexcept = 0;
+
+        std::uint64_t Deadline{0};
+        std::uint16_t List{NotScheduled};
+    };
+
+    static constexpr std::uint64_t Never = std::numeric_limits<std::uint64_t>::max();
+
+    explicit TTimerWheel(std::uint64_t now = 0) noexcept;
+    TTimerWheel(TTimerWheel&&) noexcept = delete;
+
+    // Timers already due are expired by the next Advance
+    void Insert(TTimer& timer) noexcept;
+    // Returns false if the timer isn't in the wheel, e.g. it has already been popped
+    auto Cancel(TTimer& timer) noexcept -> bool;
+    // Moves timers due by now to the expired ones, time never goes backward
+    void Advance(std::uint64_t now) noexcept;
+    auto PopExpired() noexcept -> TTimer*;
+    // Time the wheel has to be advanced at, either the earliest deadline or a cascade of a higher level
+    auto NextExpiry() const noexcept -> std::uint64_t;
+    auto Now() const noexcept -> std::uint64_t;
+    auto Size() const noexcept -> std::size_t;
+    auto Empty() const noexcept -> bool;
+
+private:
+    static constexpr std::size_t SlotBits = 6;
+    static constexpr std::size_t SlotsCount = std::size_t{1} << SlotBits;
+    static constexpr std::uint64_t SlotMask = SlotsCount - 1;
+    // 2^36 ticks, i.e. about 19 hours of microseconds
+    static constexpr std::size_t Levels = 6;
+    static constexpr std::uint16_t Overflow = Levels * SlotsCount;
+    static constexpr std::uint16_t Due = Overflow + 1;
+    static constexpr std::uint16_t Expired = Due + 1;
+    static constexpr std::uint16_t NotScheduled = std::numeric_limits<std::uint16_t>::max();
+
+    void Place(TTimer& timer) noexcept;
+    void Link(TTimer& timer, std::uint16_t list) noexcept;
+    void Cascade(std::uint16_t list) noexcept;
+
+private:
+    std::uint64_t Current;
+    std::size_t Count{0};
+    std::array<std::uint64_t, Levels> Occupied{};
+    std::array<TIntrusiveList<TTimer>, Expired + 1> Lists{};
+};
+
+}
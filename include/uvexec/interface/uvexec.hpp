@@ -32,6 +32,65 @@ struct drop_t {
     }
 };
 
+struct get_deadline_t {
+    template <typename TEnv>
+        requires stdexec::tag_invocable<get_deadline_t, const TEnv&>
+    auto operator()(const TEnv& env) const noexcept(stdexec::nothrow_tag_invocable<get_deadline_t, const TEnv&>) {
+        return stdexec::tag_invoke(*this, env);
+    }
+
+    friend constexpr auto tag_invoke(stdexec::forwarding_query_t, const get_deadline_t&) noexcept -> bool {
+        return true;
+    }
+};
+
+// Batch that collects the loop schedule senders started with the environment instead of scheduling them one by one,
+// nullptr if the batch can't take operations from the current thread anymore
+struct get_schedule_batch_t {
+    template <typename TEnv>
+        requires stdexec::tag_invocable<get_schedule_batch_t, const TEnv&>
+    auto operator()(const TEnv& env) const noexcept {
+        return stdexec::tag_invoke(*this, env);
+    }
+
+    friend constexpr auto tag_invoke(stdexec::forwarding_query_t, const get_schedule_batch_t&) noexcept -> bool {
+        return true;
+    }
+};
+
+// Spawns the sender into the scope as exec::async_scope::spawn does, but the operation is allocated with get_allocator
+// of the environment, see algorithms/spawn.hpp
+struct spawn_t {
+    template <typename TScope, stdexec::sender TSender, typename TEnv = stdexec::empty_env>
+        requires stdexec::tag_invocable<spawn_t, TScope&, TSender, TEnv>
+    void operator()(TScope& scope, TSender&& sender, TEnv env = {}) const {
+        stdexec::tag_invoke(*this, scope, std::forward<TSender>(sender), std::move(env));
+    }
+};
+
+// Calls fn(elapsed) once a period until it returns false, then completes with a value. Ticks are kept on the grid of
+// the first deadline, elapsed is the number of periods since the previous call, more than one if the loop was late
+struct every_t {
+    using TRequiredValueCompletionSignatures = stdexec::completion_signatures<stdexec::set_value_t()>;
+    using TRequiredStoppedCompletionSignatures = stdexec::completion_signatures<stdexec::set_stopped_t()>;
+
+    template <typename TRep, typename TPer, typename TFn>
+        requires std::is_nothrow_invocable_r_v<bool, std::decay_t<TFn>&, std::size_t>
+    stdexec::sender auto operator()(std::chrono::duration<TRep, TPer> period, TFn&& fn) const noexcept(
+            std::is_nothrow_invocable_v<every_t, NUvExec::TJustSender<>, std::chrono::duration<TRep, TPer>, TFn&&>) {
+        return (*this)(stdexec::just(), std::move(period), std::forward<TFn>(fn));
+    }
+
+    template <stdexec::sender TSender, typename TRep, typename TPer, typename TFn>
+        requires std::is_nothrow_invocable_r_v<bool, std::decay_t<TFn>&, std::size_t>
+    stdexec::sender auto operator()(TSender&& sender, std::chrono::duration<TRep, TPer> period, TFn&& fn) const
+            noexcept(stdexec::nothrow_tag_invocable<every_t, TSender, std::chrono::duration<TRep, TPer>, TFn&&>) {
+        auto d = NUvExec::GetEarlyDomain(sender);
+        return stdexec::transform_sender(d, NUvExec::MakeSenderPackage<every_t>(
+                std::forward<TSender>(sender), std::make_tuple(std::move(period), std::forward<TFn>(fn))));
+    }
+};
+
 struct schedule_upon_signal_t {
     template <stdexec::scheduler TScheduler, typename TSignal>
     stdexec::sender auto operator()(TScheduler&& scheduler, TSignal signal) const noexcept(
@@ -57,6 +116,24 @@ struct after_t {
         return stdexec::transform_sender(d, NUvExec::MakeSenderPackage<after_t>(
                 std::forward<TSender>(sender), std::tuple(std::move(timeout))));
     }
+
+    // The timer may fire up to slack later, so that the loop expires nearby timers together with one wakeup
+    template <typename TRep, typename TPer, typename TSlackRep, typename TSlackPer>
+    stdexec::sender auto operator()(std::chrono::duration<TRep, TPer> timeout,
+            std::chrono::duration<TSlackRep, TSlackPer> slack) const noexcept(std::is_nothrow_invocable_v<after_t,
+                    NUvExec::TJustSender<>, std::chrono::duration<TRep, TPer>,
+                    std::chrono::duration<TSlackRep, TSlackPer>>) {
+        return (*this)(stdexec::just(), std::move(timeout), std::move(slack));
+    }
+
+    template <stdexec::sender TSender, typename TRep, typename TPer, typename TSlackRep, typename TSlackPer>
+    stdexec::sender auto operator()(TSender&& sender, std::chrono::duration<TRep, TPer> timeout,
+            std::chrono::duration<TSlackRep, TSlackPer> slack) const noexcept(stdexec::nothrow_tag_invocable<
+                    after_t, TSender, std::chrono::duration<TRep, TPer>, std::chrono::duration<TSlackRep, TSlackPer>>) {
+        auto d = NUvExec::GetEarlyDomain(sender);
+        return stdexec::transform_sender(d, NUvExec::MakeSenderPackage<after_t>(
+                std::forward<TSender>(sender), std::tuple(std::move(timeout), std::move(slack))));
+    }
 };
 
 struct at_t {
@@ -76,6 +153,25 @@ struct at_t {
         return stdexec::transform_sender(d, NUvExec::MakeSenderPackage<at_t>(
                 std::forward<TSender>(sender), std::tuple(std::move(timeout))));
     }
+
+    // The timer may fire up to slack later, so that the loop expires nearby timers together with one wakeup
+    template <typename TClock, typename TDuration, typename TSlackRep, typename TSlackPer>
+    stdexec::sender auto operator()(std::chrono::time_point<TClock, TDuration> timeout,
+            std::chrono::duration<TSlackRep, TSlackPer> slack) const noexcept(std::is_nothrow_invocable_v<at_t,
+                    NUvExec::TJustSender<>, std::chrono::time_point<TClock, TDuration>,
+                    std::chrono::duration<TSlackRep, TSlackPer>>) {
+        return (*this)(stdexec::just(), std::move(timeout), std::move(slack));
+    }
+
+    template <stdexec::sender TSender, typename TClock, typename TDuration, typename TSlackRep, typename TSlackPer>
+    stdexec::sender auto operator()(TSender&& sender, std::chrono::time_point<TClock, TDuration> timeout,
+            std::chrono::duration<TSlackRep, TSlackPer> slack) const noexcept(stdexec::nothrow_tag_invocable<
+                    at_t, TSender, std::chrono::time_point<TClock, TDuration>,
+                    std::chrono::duration<TSlackRep, TSlackPer>>) {
+        auto d = NUvExec::GetEarlyDomain(sender);
+        return stdexec::transform_sender(d, NUvExec::MakeSenderPackage<at_t>(
+                std::forward<TSender>(sender), std::tuple(std::move(timeout), std::move(slack))));
+    }
 };
 
 struct upon_signal_t {
@@ -364,9 +460,17 @@ struct send_to_t {
 // Generic async destructor
 inline constexpr drop_t drop;
 
+// Deadline of an operation, set in the receiver environment
+inline constexpr get_deadline_t get_deadline;
+inline constexpr get_schedule_batch_t get_schedule_batch;
+
+// Scopes
+inline constexpr spawn_t spawn;
+
 // Timers
 inline constexpr after_t after;
 inline constexpr at_t at;
+inline constexpr every_t every;
 
 // Signal handling
 inline constexpr schedule_upon_signal_t schedule_upon_signal;
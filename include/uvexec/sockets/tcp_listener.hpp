@@ -42,6 +42,7 @@ public:
 
             void set_value() noexcept {
                 Op->Receiver.emplace(std::move(*this).base());
+                Op->Trace.Begin(NUvUtil::GetLoop(NUvUtil::RawUvObject(*Op->Socket)), "accept");
                 Op->Listener->RegisterAccept(*Op);
                 Op->StopOp.Setup();
             }
@@ -71,6 +72,7 @@ public:
             if (StopOp.Reset()) {
                 return;
             }
+            Trace.End();
             auto err = NUvUtil::Accept(NUvUtil::RawUvObject(*Listener), NUvUtil::RawUvObject(*Socket));
             if (NUvUtil::IsError(err)) {
                 stdexec::set_error(*std::move(Receiver), EErrc{err});
@@ -82,12 +84,14 @@ public:
             if (StopOp.Reset()) {
                 return;
             }
+            Trace.End();
             stdexec::set_error(*std::move(Receiver), std::move(err));
         }
 
         static void StopCallback(TAcceptOpState& op) noexcept {
             op.Listener->AcceptList.Erase(op);
             op.StopOp.ResetUnsafe();
+            op.Trace.End();
             stdexec::set_stopped(*std::move(op.Receiver));
         }
 
@@ -99,6 +103,7 @@ public:
         TTcpListener* Listener;
         TTcpSocket* Socket;
         std::optional<TReceiver> Receiver;
+        [[no_unique_address]] TTraceSpan Trace;
     };
 
     template <NMeta::IsIn<endpoints> TEp>
@@ -38,10 +38,22 @@ public:
         node.Next = Head;
         if (Head != nullptr) {
             Head->Prev = &node;
+        } else {
+            Tail = &node;
         }
         Head = &node;
     }
 
+    void PushBack(T& node) noexcept {
+        node.Prev = Tail;
+        if (Tail != nullptr) {
+            Tail->Next = &node;
+        } else {
+            Head = &node;
+        }
+        Tail = &node;
+    }
+
     auto Pop() -> T& {
         auto head = Head;
         Erase(static_cast<T&>(*Head));
@@ -58,6 +70,9 @@ public:
         if (&node == Head) {
             Head = node.Next;
         }
+        if (&node == Tail) {
+            Tail = node.Prev;
+        }
         node.Next = node.Prev = nullptr;
     }
 
@@ -68,6 +83,7 @@ public:
 
 private:
     TNode* Head{nullptr};
+    TNode* Tail{nullptr};
 };
 
 }
@@ -20,6 +20,8 @@
 
 #include <stdexec/execution.hpp>
 
+#include <span>
+
 
 namespace NUvUtil {
 
@@ -61,4 +63,7 @@ auto GetLoop(THandle& handle) -> uv_loop_t& {
 auto CopyAddress(const sockaddr* from, sockaddr_in& to) -> TUvError;
 auto CopyAddress(const sockaddr* from, sockaddr_in6& to) -> TUvError;
 
+// Pins the calling thread to the given CPUs
+auto SetCurrentThreadAffinity(std::span<const std::size_t> cpus) -> TUvError;
+
 }
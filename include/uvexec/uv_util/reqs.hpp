@@ -29,6 +29,14 @@ auto Init(uv_timer_t& timer, uv_loop_t& loop) -> TUvError;
 
 auto Init(uv_signal_t& signal, uv_loop_t& loop) -> TUvError;
 
+auto Init(uv_idle_t& idle, uv_loop_t& loop) -> TUvError;
+
+auto Init(uv_check_t& check, uv_loop_t& loop) -> TUvError;
+
+auto Init(uv_prepare_t& prepare, uv_loop_t& loop) -> TUvError;
+
+auto Init(uv_poll_t& poll, uv_loop_t& loop, int fd) -> TUvError;
+
 auto Fire(uv_async_t& req) -> TUvError;
 
 auto Now(const uv_loop_t& loop) -> std::uint64_t;
@@ -41,6 +49,22 @@ auto SignalOnce(uv_signal_t& req, uv_signal_cb cb, int signum) -> TUvError;
 
 auto SignalStop(uv_signal_t& req) -> TUvError;
 
+auto IdleStart(uv_idle_t& req, uv_idle_cb cb) -> TUvError;
+
+auto IdleStop(uv_idle_t& req) -> TUvError;
+
+auto CheckStart(uv_check_t& req, uv_check_cb cb) -> TUvError;
+
+auto CheckStop(uv_check_t& req) -> TUvError;
+
+auto PrepareStart(uv_prepare_t& req, uv_prepare_cb cb) -> TUvError;
+
+auto PrepareStop(uv_prepare_t& req) -> TUvError;
+
+auto PollStart(uv_poll_t& req, int events, uv_poll_cb cb) -> TUvError;
+
+auto PollStop(uv_poll_t& req) -> TUvError;
+
 auto Bind(uv_tcp_t& tcp, const sockaddr_in& addr) -> TUvError;
 
 auto Bind(uv_tcp_t& tcp, const sockaddr_in6& addr) -> TUvError;
@@ -95,6 +119,12 @@ void Close(uv_udp_t& handle, uv_close_cb cb);
 
 void Close(uv_idle_t& handle, uv_close_cb cb);
 
+void Close(uv_check_t& handle, uv_close_cb cb);
+
+void Close(uv_prepare_t& handle, uv_close_cb cb);
+
+void Close(uv_poll_t& handle, uv_close_cb cb);
+
 
 template <typename TUvHandle>
 concept UvHandle = requires (TUvHandle& handle) {
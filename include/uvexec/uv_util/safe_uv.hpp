@@ -74,4 +74,10 @@ void UvUdpClose(uv_udp_t* handle, uv_close_cb close_cb);
 
 void UvIdleClose(uv_idle_t* handle, uv_close_cb close_cb);
 
+void UvCheckClose(uv_check_t* handle, uv_close_cb close_cb);
+
+void UvPrepareClose(uv_prepare_t* handle, uv_close_cb close_cb);
+
+void UvPollClose(uv_poll_t* handle, uv_close_cb close_cb);
+
 }
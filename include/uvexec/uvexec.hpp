@@ -15,12 +15,19 @@
  */
 #pragma once
 
+#include "execution/loop_watchdog.hpp"
+#include "execution/task.hpp"
 #include "sockets/tcp_listener.hpp"
 #include "sockets/udp.hpp"
 #include "algorithms/accept.hpp"
 #include "algorithms/schedule.hpp"
 #include "algorithms/after.hpp"
+#include "algorithms/bulk.hpp"
+#include "algorithms/every.hpp"
+#include "algorithms/transfer.hpp"
 #include "algorithms/upon_signal.hpp"
+#include "algorithms/with_timeout.hpp"
+#include "algorithms/spawn.hpp"
 #include "algorithms/bind_to.hpp"
 #include "algorithms/connect_to.hpp"
 #include "algorithms/accept_from.hpp"
@@ -33,7 +40,23 @@ namespace uvexec {
 using errc = NUvExec::EErrc;
 
 using loop_t = NUvExec::TLoop;
+using loop_options_t = NUvExec::TLoopOptions;
+using loop_metrics_t = NUvExec::TLoopMetrics;
+template <typename T>
+using loop_allocator_t = NUvExec::TLoopAllocator<T>;
+using loop_watchdog_t = NUvExec::TLoopWatchdog;
+using loop_watchdog_options_t = NUvExec::TLoopWatchdogOptions;
 using scheduler_t = NUvExec::TLoop::TScheduler;
+using priority = NUvExec::EPriority;
+using deadline_scheduler_t = NUvExec::TLoop::TDeadlineScheduler;
+
+template <typename T = void>
+using task = NUvExec::TTask<T>;
+
+using balancing = NUvExec::EBalancing;
+using loop_pool_t = NUvExec::TLoopPool;
+using loop_pool_options_t = NUvExec::TLoopPoolOptions;
+using pool_scheduler_t = NUvExec::TLoopPool::TScheduler;
 
 using clock_t = NUvExec::TLoopClock;
 
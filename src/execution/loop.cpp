@@ -17,142 +17,676 @@
 
 #include <uvexec/uv_util/safe_uv.hpp>
 
+#include <algorithm>
+#include <bit>
+#include <tuple>
+#include <utility>
+
 
 namespace NUvExec {
 
-TLoop::TLoop(): Scheduled{}, Running{false} {
+namespace {
+
+thread_local TLoop* CurrentLoop{nullptr};
+// Schedule batches created by the current thread and not submitted yet, the latest first
+thread_local TLoop::TScheduleBatch* OpenBatches{nullptr};
+
+// Part of the batch budget every lower priority lane keeps for itself
+constexpr std::size_t LowerLaneShare = 8;
+
+// Distinct loops one phase may transfer operations to before the rest are scheduled one by one
+constexpr std::size_t OutboxCapacity = 16;
+
+// Idle operations applied per iteration, an idle iteration doesn't block in poll, so new I/O is noticed quickly
+constexpr std::size_t IdleBudget = 1;
+
+template <typename TOperationList>
+auto ApplyLane(TOperationList& lane, std::size_t budget) noexcept -> std::size_t {
+    for (std::size_t n = 0; n < budget; ++n) {
+        auto op = lane.PopFront();
+        if (op == nullptr) {
+            return n;
+        }
+        op->Apply();
+    }
+    return budget;
+}
+
+template <typename TOperationLists>
+auto Empty(const TOperationLists& lanes) noexcept -> bool {
+    return std::all_of(lanes.begin(), lanes.end(), [](const auto& lane) noexcept {
+        return lane.Empty();
+    });
+}
+
+auto PolledEvents(uv_loop_t& loop) noexcept -> std::uint64_t {
+    uv_metrics_t metrics{};
+    ::uv_metrics_info(&loop, &metrics);
+    return metrics.events;
+}
+
+}
+
+TLoop::TLoop(const TLoopOptions& options)
+    : Options(options)
+    , Scheduled{}
+    , Backlog{0}
+    , WakeupPending{false}
+    , Spinning{false}
+    , StopRequested{false}
+    , Running{false}
+{
+    Options.BatchBudget = std::max<std::size_t>(Options.BatchBudget, 1);
+    Outbox.reserve(OutboxCapacity);
     NUvUtil::Assert(::uv_loop_init(&UvLoop));
     UvLoop.data = this;
     NUvUtil::Assert(::uv_async_init(&UvLoop, &Async, ApplyOperations));
-    Async.data = &Scheduled;
+    Async.data = this;
+    NUvUtil::Assert(NUvUtil::Init(Check, UvLoop));
+    Check.data = this;
+    NUvUtil::Assert(NUvUtil::CheckStart(Check, ApplyLocalOperations));
+    NUvUtil::Assert(NUvUtil::Init(Idle, UvLoop));
+    Idle.data = this;
+    NUvUtil::Assert(NUvUtil::Init(Prepare, UvLoop));
+    Prepare.data = this;
+    NUvUtil::Assert(NUvUtil::PrepareStart(Prepare, BeforePoll));
+    NUvUtil::Assert(WheelTimer.Init(UvLoop, FireTimers, this));
+    Timers.Advance(WheelTime(TLoopClock::now()));
+    if (Options.CollectMetrics) {
+        Metrics = std::make_unique<TLoopMetrics>();
+        NUvUtil::Assert(::uv_loop_configure(&UvLoop, UV_METRICS_IDLE_TIME));
+    }
+#ifdef UVEXEC_ENABLE_TRACING
+    if (Options.TraceCapacity != 0) {
+        Trace = std::make_unique<TTraceBuffer>(Options.TraceCapacity);
+    }
+#endif
 }
 
 TLoop::~TLoop() {
     NUvUtil::Close(Async);
+    NUvUtil::Close(Check);
+    NUvUtil::Close(Idle);
+    NUvUtil::Close(Prepare);
+    WheelTimer.Close();
     ::uv_run(&UvLoop, UV_RUN_ONCE);
     NUvUtil::Panic(::uv_loop_close(&UvLoop)); // Loop is busy, rip
 }
 
-auto TLoop::get_scheduler() noexcept -> TLoop::TScheduler {
-    return TScheduler(*this);
+auto TLoop::get_scheduler(EPriority priority) noexcept -> TLoop::TScheduler {
+    return TScheduler(*this, priority);
+}
+
+auto TLoop::get_idle_scheduler() noexcept -> TLoop::TScheduler {
+    return get_scheduler(EPriority::Idle);
+}
+
+auto TLoop::get_deadline_scheduler() noexcept -> TLoop::TDeadlineScheduler {
+    return TDeadlineScheduler(*this);
+}
+
+auto TLoop::GetOptions() const noexcept -> const TLoopOptions& {
+    return Options;
+}
+
+auto TLoop::GetMetrics() const noexcept -> const TLoopMetrics* {
+    return Metrics.get();
+}
+
+auto TLoop::GetTrace() const noexcept -> const TTraceBuffer* {
+    return Trace.get();
+}
+
+auto TLoop::GetAllocator() noexcept -> TSlabAllocator& {
+    return Allocator;
 }
 
 auto TLoop::run() -> bool {
-    TRunner runner;
-    while (true) {
-        std::unique_lock lock(RunMtx);
-        if (!Running) {
-            auto stopped = RunLocked(lock, UV_RUN_DEFAULT);
-            Runners.WakeupNext();
-            return stopped;
+    return Run(UV_RUN_DEFAULT);
+}
+
+auto TLoop::run_once() -> bool {
+    return Run(UV_RUN_ONCE);
+}
+
+auto TLoop::drain() -> bool {
+    return Run(UV_RUN_NOWAIT);
+}
+
+void TLoop::finish() noexcept {
+    StopRequested.store(true, std::memory_order_relaxed);
+    ::uv_stop(&UvLoop);
+}
+
+void TLoop::Schedule(NUvExec::TLoop::TOperation& op, EPriority priority) noexcept {
+    auto lane = static_cast<std::size_t>(priority);
+    if (Metrics) {
+        Metrics->Scheduled.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (priority == EPriority::Idle) {
+        ScheduledIdle.PushBack(op);
+        if (CurrentLoop == this) {
+            NUvUtil::IdleStart(Idle, KeepPolling);
         } else {
-            Runners.Add(runner);
-            lock.unlock();
-            runner.Wait();
-            lock.lock();
-            Runners.Erase(runner);
+            Wakeup(); // The loop may be blocked in poll, which is exactly when idle work should run
         }
+        return;
+    }
+    if (CurrentLoop == this) {
+        NUvUtil::IdleStart(Idle, KeepPolling); // Don't block in poll while there is local work
+        ScheduledLocal[lane].PushBack(op);
+        return;
     }
+    if (Options.HighWaterMark != 0) {
+        Backlog.fetch_add(1, std::memory_order_relaxed); // Before the push, so the loop never sees it negative
+    }
+    Scheduled[lane].PushBack(op);
+    Wakeup();
 }
 
-auto TLoop::run_once() -> bool {
-    TRunner runner;
-    while (true) {
-        std::unique_lock lock(RunMtx);
-        if (!Running) {
-            auto stopped = RunLocked(lock, UV_RUN_ONCE);
-            Runners.WakeupNext();
-            return stopped;
-        } else {
-            Runners.Add(runner);
-            lock.unlock();
-            runner.Wait();
-            lock.lock();
-            Runners.Erase(runner);
+auto TLoop::TrySchedule(TOperation& op, EPriority priority) noexcept -> bool {
+    if (Options.HighWaterMark != 0 && CurrentLoop != this
+            && Backlog.load(std::memory_order_relaxed) >= Options.HighWaterMark) {
+        if (Metrics) {
+            Metrics->Rejected.fetch_add(1, std::memory_order_relaxed);
         }
+        return false;
     }
+    Schedule(op, priority);
+    return true;
 }
 
-auto TLoop::drain() -> bool {
-    TRunner runner;
-    while (true) {
-        std::unique_lock lock(RunMtx);
-        if (!Running) {
-            auto stopped = RunLocked(lock, UV_RUN_NOWAIT);
-            Runners.WakeupNext();
-            return stopped;
-        } else {
-            Runners.Add(runner);
-            lock.unlock();
-            runner.Wait();
-            lock.lock();
-            Runners.Erase(runner);
+void TLoop::Transfer(TOperation& op, EPriority priority) noexcept {
+    auto source = CurrentLoop;
+    if (source == nullptr || source == this) {
+        Schedule(op, priority);
+        return;
+    }
+    auto entry = std::find_if(source->Outbox.begin(), source->Outbox.end(), [this](const auto& entry) noexcept {
+        return entry.first == this;
+    });
+    if (entry == source->Outbox.end()) {
+        if (source->Outbox.size() == source->Outbox.capacity()) {
+            Schedule(op, priority); // Never reallocates, so never throws
+            return;
         }
+        entry = source->Outbox.emplace(source->Outbox.end(), this, TOperationChains{});
     }
+    entry->second.PushBack(op, priority);
+    source->OutboxPending = true;
 }
 
-void TLoop::finish() noexcept {
-    ::uv_stop(&UvLoop);
+TLoop::TScheduleBatch::TScheduleBatch(TLoop& loop) noexcept
+    : Loop{&loop}
+    , Prev{OpenBatches}
+    , Open{true}
+{
+    OpenBatches = this;
 }
 
-void TLoop::Schedule(NUvExec::TLoop::TOperation& op) noexcept {
-    Scheduled.PushBack(op);
-    NUvUtil::Fire(Async); // never returns error
+TLoop::TScheduleBatch::~TScheduleBatch() {
+    Submit();
 }
 
-void TLoop::RunnerSteal(TRunner& runner) {
-    while (!runner.Finished()) {
-        std::unique_lock lock(RunMtx);
-        if (!Running) {
-            if (runner.AcquireIfNotFinished()) {
-                RunLocked(lock, UV_RUN_DEFAULT);
+void TLoop::TScheduleBatch::PushBack(TOperation& op, EPriority priority) noexcept {
+    Operations.PushBack(op, priority);
+}
+
+auto TLoop::TScheduleBatch::TryPushBack(TOperation& op, EPriority priority) noexcept -> bool {
+    auto& options = Loop->Options;
+    if (options.HighWaterMark != 0 && CurrentLoop != Loop
+            && Loop->Backlog.load(std::memory_order_relaxed) + Operations.Pending() >= options.HighWaterMark) {
+        if (Loop->Metrics) {
+            Loop->Metrics->Rejected.fetch_add(1, std::memory_order_relaxed);
+        }
+        return false;
+    }
+    PushBack(op, priority);
+    return true;
+}
+
+void TLoop::TScheduleBatch::Submit() noexcept {
+    Close();
+    Operations.Submit(*Loop);
+}
+
+void TLoop::TScheduleBatch::Close() noexcept {
+    if (!std::exchange(Open, false)) {
+        return;
+    }
+    for (auto link = &OpenBatches; *link != nullptr; link = &(*link)->Prev) {
+        if (*link == this) {
+            *link = Prev;
+            break;
+        }
+    }
+}
+
+auto TLoop::TScheduleBatch::GetLoop() const noexcept -> TLoop& {
+    return *Loop;
+}
+
+auto TLoop::TScheduleBatch::get_env() noexcept -> TLoop::TScheduleBatch::TEnv {
+    return TEnv(*this);
+}
+
+TLoop::TScheduleBatch::TEnv::TEnv(TScheduleBatch& batch) noexcept
+    : TScheduler::TLoopEnv(*batch.Loop), Batch{&batch}
+{}
+
+auto TLoop::TScheduleBatch::TEnv::Lookup() const noexcept -> TLoop::TScheduleBatch* {
+    for (auto batch = OpenBatches; batch != nullptr; batch = batch->Prev) {
+        if (batch == Batch) {
+            return batch;
+        }
+    }
+    return nullptr;
+}
+
+auto tag_invoke(uvexec::get_schedule_batch_t, const TLoop::TScheduleBatch::TEnv& env) noexcept
+        -> TLoop::TScheduleBatch* {
+    return env.Lookup();
+}
+
+void TLoop::TOperationChains::PushBack(TOperation& op, EPriority priority) noexcept {
+    auto& chain = Chains[static_cast<std::size_t>(priority)];
+    op.Next.store(nullptr, std::memory_order_relaxed);
+    if (chain.Last != nullptr) {
+        chain.Last->Next.store(&op, std::memory_order_relaxed);
+    } else {
+        chain.First = &op;
+    }
+    chain.Last = &op;
+    ++Size;
+    if (priority == EPriority::Idle) {
+        ++IdleSize;
+    }
+}
+
+auto TLoop::TOperationChains::Pending() const noexcept -> std::size_t {
+    return Size - IdleSize;
+}
+
+void TLoop::TOperationChains::Submit(TLoop& loop) noexcept {
+    if (Size == 0) {
+        return;
+    }
+    if (loop.Metrics) {
+        loop.Metrics->Scheduled.fetch_add(Size, std::memory_order_relaxed);
+    }
+    auto local = CurrentLoop == &loop;
+    if (local) {
+        for (std::size_t lane = 0; lane < PrioritiesCount; ++lane) {
+            for (auto op = Chains[lane].First; op != nullptr;) {
+                auto next = op->Next.load(std::memory_order_relaxed);
+                loop.ScheduledLocal[lane].PushBack(*op);
+                op = next;
             }
-            Runners.WakeupNext();
-        } else {
-            Runners.Add(runner);
-            lock.unlock();
-            runner.Wait();
-            lock.lock();
-            Runners.Erase(runner);
         }
+        NUvUtil::IdleStart(loop.Idle, KeepPolling);
+    } else {
+        if (loop.Options.HighWaterMark != 0) {
+            loop.Backlog.fetch_add(Size - IdleSize, std::memory_order_relaxed);
+        }
+        for (std::size_t lane = 0; lane < PrioritiesCount; ++lane) {
+            if (Chains[lane].First != nullptr) {
+                loop.Scheduled[lane].PushBack(*Chains[lane].First, *Chains[lane].Last);
+            }
+        }
+    }
+    if (auto& idle = Chains[static_cast<std::size_t>(EPriority::Idle)]; idle.First != nullptr) {
+        loop.ScheduledIdle.PushBack(*idle.First, *idle.Last);
+    }
+    if (!local) {
+        loop.Wakeup();
+    }
+    Chains = {};
+    Size = IdleSize = 0;
+}
+
+auto TLoop::GetBacklog() const noexcept -> std::size_t {
+    return Backlog.load(std::memory_order_relaxed);
+}
+
+void TLoop::ScheduleByDeadline(TDeadlineOperation& op) noexcept {
+    if (Metrics) {
+        Metrics->Scheduled.fetch_add(1, std::memory_order_relaxed);
+    }
+    NUvUtil::IdleStart(Idle, KeepPolling);
+    ScheduledByDeadline.Push(op);
+}
+
+void TLoop::RunnerSteal(TRunner& runner) {
+    std::unique_lock lock(RunMtx);
+    while (AwaitLeadership(lock, runner)) {
+        RunLeading(lock, runner, UV_RUN_DEFAULT);
+    }
+}
+
+void TLoop::StartTimer(TTimer& timer, TLoopClock::time_point deadline, TLoopClock::duration slack) noexcept {
+    // The wheel is only advanced by expirations, catching up first keeps the new timer at a low level
+    Timers.Advance(WheelTime(TLoopClock::now()));
+    // Rounded up, so that a timer never expires before its deadline
+    auto ticks = static_cast<std::uint64_t>(std::max(
+            std::chrono::ceil<std::chrono::microseconds>(deadline.time_since_epoch()).count(), std::int64_t{0}));
+    if (auto grain = std::bit_floor(static_cast<std::uint64_t>(
+            std::max(std::chrono::floor<std::chrono::microseconds>(slack).count(), std::int64_t{0}))); grain > 1) {
+        ticks = ticks > TTimerWheel::Never - grain ? ticks : (ticks + grain - 1) & ~(grain - 1);
     }
+    timer.Deadline = ticks;
+    Timers.Insert(timer);
+    ArmTimer();
+}
+
+auto TLoop::StopTimer(TTimer& timer) noexcept -> bool {
+    if (!Timers.Cancel(timer)) {
+        return false;
+    }
+    if (Timers.Empty()) {
+        ArmTimer(); // Stops the timerfd poll (the uv timer elsewhere), so an empty wheel no longer wakes the loop up
+    }
+    return true;
+}
+
+auto TLoop::Current() noexcept -> TLoop* {
+    return CurrentLoop;
 }
 
 TLoop::TOperationList::TOperationList() noexcept
-    : Head{nullptr}
+    : Tail{&Stub}, Head{&Stub}
 {}
 
 void TLoop::TOperationList::PushBack(TOperation& op) noexcept {
-    auto curTop = Head.load(std::memory_order_relaxed);
-    do {
-        op.Next = curTop;
-    } while (!Head.compare_exchange_weak(curTop, &op, std::memory_order_release, std::memory_order_relaxed));
+    op.Next.store(nullptr, std::memory_order_relaxed);
+    auto prev = Tail.exchange(&op, std::memory_order_acq_rel);
+    prev->Next.store(&op, std::memory_order_release);
+}
+
+void TLoop::TOperationList::PushBack(TOperation& first, TOperation& last) noexcept {
+    last.Next.store(nullptr, std::memory_order_relaxed);
+    auto prev = Tail.exchange(&last, std::memory_order_acq_rel);
+    prev->Next.store(&first, std::memory_order_release);
 }
 
-auto TLoop::TOperationList::Grab() noexcept -> TLoop::TOperation* {
-    auto opStates = Head.exchange(nullptr, std::memory_order_acquire);
-    TOperation* newTop = nullptr;
-    auto cur = opStates;
-    while (cur != nullptr) {
-        auto next = cur->Next;
-        cur->Next = newTop;
-        newTop = cur;
-        cur = next;
+auto TLoop::TOperationList::PopFront() noexcept -> TLoop::TOperation* {
+    auto head = Head;
+    auto next = head->Next.load(std::memory_order_acquire);
+    if (head == &Stub) {
+        if (next == nullptr) {
+            return nullptr;
+        }
+        Head = next;
+        head = next;
+        next = next->Next.load(std::memory_order_acquire);
+    }
+    if (next != nullptr) {
+        Head = next;
+        return head;
+    }
+    if (head != Tail.load(std::memory_order_acquire)) {
+        return nullptr; // Producer hasn't linked its operation yet
     }
-    return newTop;
+    PushBack(Stub); // head is the last one, put the stub behind it to detach it
+    next = head->Next.load(std::memory_order_acquire);
+    if (next != nullptr) {
+        Head = next;
+        return head;
+    }
+    return nullptr;
+}
+
+auto TLoop::TOperationList::Empty() const noexcept -> bool {
+    return Head == &Stub && Tail.load(std::memory_order_acquire) == &Stub;
+}
+
+void TLoop::TDeadlineHeap::Push(TDeadlineOperation& op) noexcept {
+    op.Seq = Seq++;
+    op.Child = op.Sibling = nullptr;
+    Root = Meld(Root, &op);
+}
+
+auto TLoop::TDeadlineHeap::Pop() noexcept -> TLoop::TDeadlineOperation* {
+    auto top = Root;
+    if (top != nullptr) {
+        Root = MeldPairs(top->Child);
+        top->Child = nullptr;
+    }
+    return top;
+}
+
+auto TLoop::TDeadlineHeap::Empty() const noexcept -> bool {
+    return Root == nullptr;
+}
+
+auto TLoop::TDeadlineHeap::Meld(TDeadlineOperation* lhs, TDeadlineOperation* rhs) noexcept
+        -> TLoop::TDeadlineOperation* {
+    if (lhs == nullptr) {
+        return rhs;
+    }
+    if (rhs == nullptr) {
+        return lhs;
+    }
+    if (std::tie(rhs->Deadline, rhs->Seq) < std::tie(lhs->Deadline, lhs->Seq)) {
+        std::swap(lhs, rhs);
+    }
+    rhs->Sibling = lhs->Child;
+    lhs->Child = rhs;
+    return lhs;
+}
+
+auto TLoop::TDeadlineHeap::MeldPairs(TDeadlineOperation* first) noexcept -> TLoop::TDeadlineOperation* {
+    // Meld siblings pairwise left to right, then meld the pairs right to left
+    TDeadlineOperation* pairs = nullptr;
+    while (first != nullptr) {
+        auto second = first->Sibling;
+        auto rest = second != nullptr ? second->Sibling : nullptr;
+        first->Sibling = nullptr;
+        if (second != nullptr) {
+            second->Sibling = nullptr;
+        }
+        auto pair = Meld(first, second);
+        pair->Sibling = pairs;
+        pairs = pair;
+        first = rest;
+    }
+    TDeadlineOperation* root = nullptr;
+    while (pairs != nullptr) {
+        auto next = pairs->Sibling;
+        pairs->Sibling = nullptr;
+        root = Meld(root, pairs);
+        pairs = next;
+    }
+    return root;
+}
+
+void TLoop::TLocalOperationList::PushBack(TOperation& op) noexcept {
+    op.Next.store(nullptr, std::memory_order_relaxed);
+    if (Tail != nullptr) {
+        Tail->Next.store(&op, std::memory_order_relaxed);
+    } else {
+        Head = &op;
+    }
+    Tail = &op;
+}
+
+void TLoop::TLocalOperationList::Splice(TLocalOperationList& other) noexcept {
+    if (other.Head == nullptr) {
+        return;
+    }
+    if (Tail != nullptr) {
+        Tail->Next.store(other.Head, std::memory_order_relaxed);
+    } else {
+        Head = other.Head;
+    }
+    Tail = std::exchange(other.Tail, nullptr);
+    other.Head = nullptr;
+}
+
+auto TLoop::TLocalOperationList::PopFront() noexcept -> TLoop::TOperation* {
+    auto op = Head;
+    if (op != nullptr) {
+        Head = op->Next.load(std::memory_order_relaxed);
+        if (Head == nullptr) {
+            Tail = nullptr;
+        }
+    }
+    return op;
+}
+
+auto TLoop::TLocalOperationList::Empty() const noexcept -> bool {
+    return Head == nullptr;
 }
 
 void TLoop::ApplyOperations(uv_async_t* async) {
-    auto opStates = static_cast<TOperationList*>(async->data)->Grab();
+    static_cast<TLoop*>(async->data)->ApplyScheduled();
+}
 
-    auto op = opStates;
-    while (op != nullptr) {
-        auto next = op->Next;
-        op->Apply();
-        op = next;
+void TLoop::ApplyLocalOperations(uv_check_t* check) {
+    auto& loop = *static_cast<TLoop*>(check->data);
+    auto events = PolledEvents(loop.UvLoop);
+    auto polledNothing = events == loop.LastPolledEvents;
+    loop.LastPolledEvents = events;
+    // Local lanes go first, operations they hand over to the deadline heap are still ordered in this iteration
+    auto applied = loop.ApplyLanes(loop.ReadyLocal);
+    for (; applied < loop.Options.BatchBudget; ++applied) {
+        auto op = loop.ScheduledByDeadline.Pop();
+        if (op == nullptr) {
+            break;
+        }
+        op->ApplyOrdered();
+    }
+    if (polledNothing && Empty(loop.ReadyLocal) && Empty(loop.ScheduledLocal) && loop.ScheduledByDeadline.Empty()) {
+        applied += ApplyLane(loop.ScheduledIdle, IdleBudget);
+    }
+    loop.RecordBatch(applied);
+    loop.FlushOutbox();
+    if (Empty(loop.ReadyLocal) && Empty(loop.ScheduledLocal) && loop.ScheduledByDeadline.Empty()
+            && loop.ScheduledIdle.Empty()) {
+        NUvUtil::IdleStop(loop.Idle);
+    } else {
+        NUvUtil::IdleStart(loop.Idle, KeepPolling); // Idle work may have been scheduled from another thread
+    }
+}
+
+void TLoop::KeepPolling(uv_idle_t*) {}
+
+void TLoop::BeforePoll(uv_prepare_t* prepare) {
+    auto& loop = *static_cast<TLoop*>(prepare->data);
+    if (loop.Metrics) {
+        loop.RecordIteration();
+    }
+    loop.FlushOutbox(); // Timer, pending and closing callbacks may have transferred operations
+    for (std::size_t lane = 0; lane < PrioritiesCount; ++lane) {
+        loop.ReadyLocal[lane].Splice(loop.ScheduledLocal[lane]);
+    }
+}
+
+void TLoop::FireTimers(void* data) {
+    auto& loop = *static_cast<TLoop*>(data);
+    if (loop.Metrics) {
+        loop.Metrics->TimerTicks.fetch_add(1, std::memory_order_relaxed);
     }
+    loop.ArmedAt = TTimerWheel::Never;
+    loop.Timers.Advance(WheelTime(TLoopClock::now()));
+    while (auto expired = loop.Timers.PopExpired()) {
+        expired->Fire();
+    }
+    loop.ArmTimer();
+}
+
+void TLoop::ArmTimer() noexcept {
+    auto next = Timers.NextExpiry();
+    if (next == ArmedAt) {
+        return;
+    }
+    ArmedAt = next;
+    if (next == TTimerWheel::Never) {
+        WheelTimer.Stop();
+        return;
+    }
+    NUvUtil::Assert(WheelTimer.Start(TLoopClock::time_point(std::chrono::microseconds(next))));
+}
+
+auto TLoop::WheelTime(TLoopClock::time_point time) noexcept -> std::uint64_t {
+    return static_cast<std::uint64_t>(std::chrono::floor<std::chrono::microseconds>(time.time_since_epoch()).count());
+}
+
+void TLoop::RecordIteration() noexcept {
+    auto now = ::uv_hrtime();
+    auto idle = ::uv_metrics_idle_time(&UvLoop);
+    if (LastPrepareTime != 0) {
+        auto elapsed = now - LastPrepareTime;
+        Metrics->IterationTimesNs.Record(elapsed - std::min(elapsed, idle - LastIdleTime));
+        Metrics->Iterations.fetch_add(1, std::memory_order_relaxed);
+    }
+    LastPrepareTime = now;
+    LastIdleTime = idle;
+    Metrics->IdleTimeNs.store(idle, std::memory_order_relaxed);
+    Metrics->ActiveHandles.store(UvLoop.active_handles, std::memory_order_relaxed);
+}
+
+void TLoop::FlushOutbox() noexcept {
+    if (!OutboxPending) {
+        return;
+    }
+    OutboxPending = false;
+    for (auto& [target, operations] : Outbox) {
+        operations.Submit(*target);
+    }
+    Outbox.clear(); // Targets are looked up linearly and may be destroyed before the next phase
 }
 
+void TLoop::RecordBatch(std::size_t applied) noexcept {
+    if (Metrics && applied != 0) {
+        Metrics->Applied.fetch_add(applied, std::memory_order_relaxed);
+        Metrics->BatchSizes.Record(applied);
+    }
+}
+
+auto TLoop::ApplyScheduled() noexcept -> std::size_t {
+    // Producers pushing after this point have to wake the loop up again
+    WakeupPending.exchange(false, std::memory_order_acq_rel);
+    auto applied = ApplyLanes(Scheduled);
+    if (Options.HighWaterMark != 0) {
+        Backlog.fetch_sub(applied, std::memory_order_relaxed);
+    }
+    RecordBatch(applied);
+    if (applied == Options.BatchBudget) {
+        Wakeup(); // Budget is exhausted, let I/O be polled before the rest
+    }
+    return applied;
+}
+
+template <typename TOperationLists>
+auto TLoop::ApplyLanes(TOperationLists& lanes) noexcept -> std::size_t {
+    const auto budget = Options.BatchBudget;
+    // Every lower lane keeps at least one operation as long as the budget is enough for all of them
+    const auto reserved = budget >= lanes.size() ? std::max<std::size_t>(1, budget / LowerLaneShare) : 0;
+    std::size_t applied = 0;
+    // Higher lanes can't take the share reserved for the lower ones...
+    for (std::size_t lane = 0; lane < lanes.size(); ++lane) {
+        auto keep = std::min(budget - applied, reserved * (lanes.size() - lane - 1));
+        applied += ApplyLane(lanes[lane], budget - applied - keep);
+    }
+    // ...unless the lower ones didn't need it
+    for (std::size_t lane = 0; lane < lanes.size() && applied < budget; ++lane) {
+        applied += ApplyLane(lanes[lane], budget - applied);
+    }
+    return applied;
+}
+
+void TLoop::Wakeup() noexcept {
+    if (Options.SpinBudget > std::chrono::nanoseconds::zero()) {
+        std::atomic_thread_fence(std::memory_order_seq_cst); // Pairs with the one in StopSpinning
+        if (Spinning.load(std::memory_order_relaxed)) {
+            return; // Spinning loop drains the queue by itself
+        }
+    }
+    // Only the first producer since the last drain fires the async handle
+    if (!WakeupPending.exchange(true, std::memory_order_acq_rel)) {
+        NUvUtil::Fire(Async); // never returns error
+    }
+}
 
 auto tag_invoke(NUvUtil::TRawUvObject, TLoop& loop) noexcept -> uv_loop_t& {
     return loop.UvLoop;
@@ -166,20 +700,114 @@ void TLoop::Walk(uv_walk_cb cb, void* arg) {
     ::uv_walk(&UvLoop, cb, arg);
 }
 
-auto TLoop::RunLocked(std::unique_lock<std::mutex>& lock, uv_run_mode mode) -> bool {
-    Running = true;
-    lock.unlock();
-    auto stopped = ::uv_run(&UvLoop, mode);
+auto TLoop::Run(uv_run_mode mode) -> bool {
+    TRunner runner;
+    std::unique_lock lock(RunMtx);
+    AwaitLeadership(lock, runner); // Never fails, nobody finishes this runner
+    return RunLeading(lock, runner, mode);
+}
+
+auto TLoop::AwaitLeadership(std::unique_lock<std::mutex>& lock, TRunner& runner) -> bool {
+    while (!runner.Finished()) {
+        if (!Running) {
+            Running = true;
+            lock.unlock();
+            return true;
+        }
+        Runners.Add(runner);
+        lock.unlock();
+        runner.Wait();
+        if (runner.TakePromotion()) {
+            return true;
+        }
+        lock.lock();
+        if (runner.TakePromotion()) { // Promoted right after finishing, still have to hand the loop over
+            lock.unlock();
+            return true;
+        }
+        Runners.Erase(runner);
+    }
+    return false;
+}
+
+auto TLoop::RunLeading(std::unique_lock<std::mutex>& lock, TRunner& runner, uv_run_mode mode) -> bool {
+    bool stopped = false;
+    if (runner.AcquireIfNotFinished()) {
+        auto prevLoop = std::exchange(CurrentLoop, this);
+        if (Options.SpinBudget > std::chrono::nanoseconds::zero() && mode != UV_RUN_NOWAIT) {
+            stopped = RunSpinning(mode);
+        } else {
+            stopped = ::uv_run(&UvLoop, mode) != 0;
+        }
+        StopRequested.store(false, std::memory_order_relaxed);
+        FlushOutbox(); // Closing callbacks of the last iteration run after the check phase
+        CurrentLoop = prevLoop;
+        LastPrepareTime = 0; // Time until the next run isn't spent by the loop
+    }
     lock.lock();
-    Running = false;
-    return stopped != 0;
+    if (!Runners.PromoteNext()) {
+        Running = false;
+    }
+    return stopped;
+}
+
+auto TLoop::RunSpinning(uv_run_mode mode) -> bool {
+    const auto budget = static_cast<std::uint64_t>(Options.SpinBudget.count());
+    while (true) {
+        Spinning.store(true, std::memory_order_relaxed);
+        auto events = PolledEvents(UvLoop);
+        auto spinUntil = ::uv_hrtime() + budget;
+        do {
+            auto alive = ::uv_run(&UvLoop, UV_RUN_NOWAIT) != 0;
+            auto applied = ApplyScheduled();
+            if (!alive || StopRequested.load(std::memory_order_relaxed)) {
+                StopSpinning();
+                return alive;
+            }
+            auto curEvents = PolledEvents(UvLoop);
+            if (applied != 0 || curEvents != events) {
+                events = curEvents;
+                spinUntil = ::uv_hrtime() + budget;
+            }
+        } while (::uv_hrtime() < spinUntil);
+
+        StopSpinning();
+        auto alive = ::uv_run(&UvLoop, UV_RUN_ONCE) != 0;
+        if (mode == UV_RUN_ONCE || !alive || StopRequested.load(std::memory_order_relaxed)) {
+            return alive;
+        }
+    }
+}
+
+void TLoop::StopSpinning() noexcept {
+    Spinning.store(false, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst); // Either we see the push or its producer sees us blocking
+    if (!Empty(Scheduled) || !ScheduledIdle.Empty()) {
+        Wakeup();
+    }
 }
 
 auto TLoop::TDomain::GetLoop(const TLoop::TScheduler& sch) const noexcept -> TLoop& {
     return *sch.Loop;
 }
 
-TLoop::TScheduler::TScheduler(TLoop& loop) noexcept
+auto TLoop::TDomain::GetLoop(const TLoop::TDeadlineScheduler& sch) const noexcept -> TLoop& {
+    return *sch.Loop;
+}
+
+auto TLoop::TDomain::GetPriority(const TLoop::TScheduler& sch) const noexcept -> EPriority {
+    return sch.Priority;
+}
+
+TLoop::TScheduler::TScheduler(TLoop& loop, EPriority priority) noexcept
+    : Loop{&loop}, Priority{priority}
+{}
+
+TLoop::TDeadlineScheduler::TDeadlineScheduler(TLoop& loop) noexcept
+    : Loop{&loop}
+{}
+
+TLoop::TDeadlineScheduler::TEnv::TEnv(TLoop& loop) noexcept
     : Loop{&loop}
 {}
 
@@ -187,16 +815,32 @@ TLoop::TScheduler::TLoopEnv::TLoopEnv(TLoop& loop) noexcept
         : Loop{&loop}
 {}
 
-TLoop::TScheduler::TEnv::TEnv(TLoop& loop) noexcept
-    : Loop{&loop}
+TLoop::TScheduler::TEnv::TEnv(TLoop& loop, EPriority priority) noexcept
+    : Loop{&loop}, Priority{priority}
 {}
 
 auto tag_invoke(stdexec::get_domain_t, const TLoop::TScheduler&) noexcept -> TLoop::TDomain {
     return {};
 }
 
-auto tag_invoke(exec::now_t, const TLoop::TScheduler& s) noexcept -> std::chrono::time_point<TLoopClock> {
-    return TLoopClock::time_point(std::chrono::milliseconds(NUvUtil::Now(NUvUtil::RawUvObject(*s.Loop))));
+auto TLoopClock::now() noexcept -> TLoopClock::time_point {
+    return time_point(duration(static_cast<rep>(::uv_hrtime())));
+}
+
+auto tag_invoke(exec::now_t, const TLoop::TScheduler&) noexcept -> std::chrono::time_point<TLoopClock> {
+    return TLoopClock::now();
+}
+
+auto tag_invoke(stdexec::get_domain_t, const TLoop::TDeadlineScheduler&) noexcept -> TLoop::TDomain {
+    return {};
+}
+
+auto tag_invoke(stdexec::get_domain_t, const TLoop::TDeadlineScheduler::TEnv&) noexcept -> TLoop::TDomain {
+    return {};
+}
+
+auto tag_invoke(exec::now_t, const TLoop::TDeadlineScheduler& s) noexcept -> std::chrono::time_point<TLoopClock> {
+    return exec::now(s.Loop->get_scheduler());
 }
 
 auto tag_invoke(stdexec::get_scheduler_t, const TLoop::TScheduler::TLoopEnv& env) noexcept -> TLoop::TScheduler {
@@ -207,6 +851,11 @@ auto tag_invoke(stdexec::get_domain_t, const TLoop::TScheduler::TLoopEnv&) noexc
     return {};
 }
 
+auto tag_invoke(stdexec::get_allocator_t, const TLoop::TScheduler::TLoopEnv& env) noexcept
+        -> TLoopAllocator<std::byte> {
+    return TLoopAllocator<std::byte>(*env.Loop);
+}
+
 auto tag_invoke(stdexec::get_domain_t, const TLoop::TScheduler::TEnv&) noexcept -> TLoop::TDomain {
     return {};
 }
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2024 Michael Guzov
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <uvexec/execution/loop_allocator.hpp>
+#include <uvexec/execution/loop.hpp>
+#include <uvexec/uv_util/errors.hpp>
+
+#include <algorithm>
+#include <new>
+#include <utility>
+
+
+namespace NUvExec {
+
+namespace {
+
+constexpr std::size_t HeapClass = ~std::size_t{0};
+
+static_assert(TSlabAllocator::Alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+
+}
+
+TSlabAllocator::~TSlabAllocator() {
+    if (LiveBlocks.load(std::memory_order_acquire) != 0) {
+        NUvUtil::Panic(UV_EBUSY); // Live blocks would be freed into the released slabs
+    }
+}
+
+auto TSlabAllocator::Allocate(std::size_t size) -> void* {
+    auto cls = ClassOf(size);
+    if (cls == HeapClass) {
+        return AllocateUnpooled(size);
+    }
+    auto& sizeClass = Classes[cls];
+    if (sizeClass.Free == nullptr) {
+        sizeClass.Free = sizeClass.RemoteFree.exchange(nullptr, std::memory_order_acquire);
+    }
+    if (sizeClass.Free == nullptr) {
+        return Refill(cls);
+    }
+    auto block = std::exchange(sizeClass.Free, sizeClass.Free->Next);
+    auto header = ::new (block) THeader{this, cls};
+    LiveBlocks.fetch_add(1, std::memory_order_relaxed);
+    return header + 1;
+}
+
+auto TSlabAllocator::AllocateUnpooled(std::size_t size) -> void* {
+    auto header = ::new (::operator new(sizeof(THeader) + size)) THeader{nullptr, HeapClass};
+    return header + 1;
+}
+
+void TSlabAllocator::Deallocate(void* ptr) noexcept {
+    if (ptr == nullptr) {
+        return;
+    }
+    auto& header = *(static_cast<THeader*>(ptr) - 1);
+    if (header.Owner == nullptr) {
+        ::operator delete(&header);
+    } else if (auto loop = TLoop::Current(); loop != nullptr && &loop->GetAllocator() == header.Owner) {
+        header.Owner->DeallocateLocal(header);
+    } else {
+        header.Owner->DeallocateRemote(header);
+    }
+}
+
+auto TSlabAllocator::GetLiveBlocks() const noexcept -> std::size_t {
+    return LiveBlocks.load(std::memory_order_relaxed);
+}
+
+auto TSlabAllocator::ClassOf(std::size_t size) noexcept -> std::size_t {
+    auto total = sizeof(THeader) + size;
+    auto it = std::lower_bound(ClassSizes.begin(), ClassSizes.end(), total);
+    return it == ClassSizes.end() ? HeapClass : static_cast<std::size_t>(it - ClassSizes.begin());
+}
+
+auto TSlabAllocator::Refill(std::size_t cls) -> void* {
+    auto& sizeClass = Classes[cls];
+    auto blockSize = ClassSizes[cls];
+    if (static_cast<std::size_t>(sizeClass.End - sizeClass.Cursor) < blockSize) {
+        // Blocks of one class are carved from the same slab, so neighbouring operations share cache lines and pages
+        auto& slab = Slabs.emplace_back(std::make_unique_for_overwrite<std::byte[]>(SlabSize));
+        sizeClass.Cursor = slab.get();
+        sizeClass.End = slab.get() + SlabSize;
+    }
+    auto header = ::new (std::exchange(sizeClass.Cursor, sizeClass.Cursor + blockSize)) THeader{this, cls};
+    LiveBlocks.fetch_add(1, std::memory_order_relaxed);
+    return header + 1;
+}
+
+void TSlabAllocator::DeallocateLocal(THeader& header) noexcept {
+    auto& sizeClass = Classes[header.Class];
+    sizeClass.Free = ::new (&header) TBlock{sizeClass.Free};
+    LiveBlocks.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void TSlabAllocator::DeallocateRemote(THeader& header) noexcept {
+    auto& sizeClass = Classes[header.Class];
+    auto block = ::new (&header) TBlock{sizeClass.RemoteFree.load(std::memory_order_relaxed)};
+    while (!sizeClass.RemoteFree.compare_exchange_weak(
+            block->Next, block, std::memory_order_release, std::memory_order_relaxed)) {}
+    LiveBlocks.fetch_sub(1, std::memory_order_release); // The block is not touched by this thread anymore
+}
+
+auto AllocateOnLoop(TLoop* loop, std::size_t size) -> void* {
+    if (loop != nullptr && TLoop::Current() == loop) {
+        return loop->GetAllocator().Allocate(size);
+    }
+    return TSlabAllocator::AllocateUnpooled(size);
+}
+
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2024 Michael Guzov
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <uvexec/execution/loop_metrics.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+
+namespace NUvExec {
+
+void TLog2Histogram::Record(std::uint64_t value) noexcept {
+    Buckets[std::bit_width(value)].fetch_add(1, std::memory_order_relaxed);
+    Total.fetch_add(value, std::memory_order_relaxed);
+}
+
+auto TLog2Histogram::Count() const noexcept -> std::uint64_t {
+    std::uint64_t count = 0;
+    for (auto& bucket : Buckets) {
+        count += bucket.load(std::memory_order_relaxed);
+    }
+    return count;
+}
+
+auto TLog2Histogram::Sum() const noexcept -> std::uint64_t {
+    return Total.load(std::memory_order_relaxed);
+}
+
+auto TLog2Histogram::Bucket(std::size_t idx) const noexcept -> std::uint64_t {
+    return Buckets[idx].load(std::memory_order_relaxed);
+}
+
+auto TLog2Histogram::Quantile(double quantile) const noexcept -> std::uint64_t {
+    std::array<std::uint64_t, BucketsCount> snapshot;
+    std::uint64_t count = 0;
+    for (std::size_t i = 0; i < BucketsCount; ++i) {
+        snapshot[i] = Buckets[i].load(std::memory_order_relaxed);
+        count += snapshot[i];
+    }
+    if (count == 0) {
+        return 0;
+    }
+    auto rank = std::min(static_cast<std::uint64_t>(quantile * static_cast<double>(count)), count - 1);
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < BucketsCount; ++i) {
+        seen += snapshot[i];
+        if (seen > rank) {
+            return i == 0 ? 0 : std::numeric_limits<std::uint64_t>::max() >> (64 - i);
+        }
+    }
+    return std::numeric_limits<std::uint64_t>::max();
+}
+
+auto TLoopMetrics::QueueDepth() const noexcept -> std::uint64_t {
+    auto applied = Applied.load(std::memory_order_relaxed);
+    auto scheduled = Scheduled.load(std::memory_order_relaxed);
+    return scheduled > applied ? scheduled - applied : 0;
+}
+
+auto TLoopMetrics::IdleTime() const noexcept -> std::chrono::nanoseconds {
+    return std::chrono::nanoseconds(IdleTimeNs.load(std::memory_order_relaxed));
+}
+
+}
@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) 2024 Michael Guzov
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <uvexec/execution/loop_pool.hpp>
+#include <uvexec/uv_util/misc.hpp>
+
+#include <system_error>
+
+
+namespace NUvExec {
+
+namespace {
+
+thread_local const TLoopPool* CurrentPool{nullptr};
+thread_local std::size_t CurrentWorker{0};
+
+}
+
+TLoopPool::TLoopPool(std::size_t size): TLoopPool(TLoopPoolOptions{.Size = size, .Affinity = {}}) {}
+
+TLoopPool::TLoopPool(const TLoopPoolOptions& options): Next{0}, Joined{false} {
+    auto size = std::max<std::size_t>(options.Size, 1);
+    Workers.resize(size);
+    Threads.reserve(size);
+    std::vector<NUvUtil::TUvError> errors(size, 0);
+    std::latch started(static_cast<std::ptrdiff_t>(size));
+    for (std::size_t i = 0; i < size; ++i) {
+        Threads.emplace_back(&TLoopPool::Work, this, i, std::cref(options), std::ref(started), std::ref(errors[i]));
+    }
+    started.wait();
+    for (auto err : errors) {
+        if (NUvUtil::IsError(err)) {
+            Stop();
+            throw std::system_error(EErrc{err});
+        }
+    }
+}
+
+TLoopPool::~TLoopPool() {
+    Stop();
+}
+
+void TLoopPool::Stop() noexcept {
+    for (auto& worker : Workers) {
+        worker->Loop.Schedule(worker->Finish);
+    }
+    for (auto& thread : Threads) {
+        thread.join();
+    }
+    Joined = true;
+    // Stealable operations nobody got to are completed with stopped on this thread
+    for (std::size_t idx = 0; idx < Workers.size(); ++idx) {
+        while (auto op = Pop(idx)) {
+            op->Apply();
+        }
+    }
+}
+
+auto TLoopPool::get_scheduler(EBalancing balancing) noexcept -> TLoopPool::TScheduler {
+    return TScheduler(*this, balancing);
+}
+
+auto TLoopPool::get_scheduler(std::size_t idx) noexcept -> TLoop::TScheduler {
+    return Loop(idx).get_scheduler();
+}
+
+auto TLoopPool::size() const noexcept -> std::size_t {
+    return Workers.size();
+}
+
+auto TLoopPool::Loop(std::size_t idx) noexcept -> TLoop& {
+    return Workers[idx]->Loop;
+}
+
+auto TLoopPool::Pick(EBalancing balancing) noexcept -> std::size_t {
+    switch (balancing) {
+        case EBalancing::LeastLoaded: {
+            std::size_t idx = 0;
+            auto minLoad = Workers[0]->Load.load(std::memory_order_relaxed);
+            for (std::size_t i = 1; i < Workers.size() && minLoad != 0; ++i) {
+                auto load = Workers[i]->Load.load(std::memory_order_relaxed);
+                if (load < minLoad) {
+                    idx = i;
+                    minLoad = load;
+                }
+            }
+            return idx;
+        }
+        case EBalancing::WorkStealing:
+            if (CurrentPool == this) {
+                return CurrentWorker;
+            }
+            [[fallthrough]];
+        default:
+            return Next.fetch_add(1, std::memory_order_relaxed) % Workers.size();
+    }
+}
+
+void TLoopPool::Schedule(std::size_t idx, TLoop::TOperation& op, EBalancing balancing) noexcept {
+    auto& worker = *Workers[idx];
+    worker.Load.fetch_add(1, std::memory_order_relaxed);
+    if (balancing == EBalancing::WorkStealing) {
+        Push(idx, op);
+    } else {
+        worker.Loop.Schedule(op);
+    }
+}
+
+void TLoopPool::Release(std::size_t idx) noexcept {
+    Workers[idx]->Load.fetch_sub(1, std::memory_order_relaxed);
+}
+
+auto TLoopPool::Stopped() const noexcept -> bool {
+    return Joined;
+}
+
+void TLoopPool::Work(std::size_t idx, const TLoopPoolOptions& options, std::latch& started, NUvUtil::TUvError& err) {
+    if (!options.Affinity.empty()) {
+        err = NUvUtil::SetCurrentThreadAffinity(options.Affinity[idx % options.Affinity.size()]);
+    }
+    Workers[idx] = std::make_unique<TWorker>(*this, idx);
+    CurrentPool = this;
+    CurrentWorker = idx;
+    auto& worker = *Workers[idx];
+    started.count_down(); // Neither options nor err may be touched after this point
+    worker.Loop.RunnerSteal(worker.Runner);
+}
+
+void TLoopPool::Push(std::size_t idx, TLoop::TOperation& op) noexcept {
+    auto& worker = *Workers[idx];
+    auto owner = CurrentPool == this && CurrentWorker == idx;
+    if (!(owner ? worker.Queue.Push(op) : worker.Inbox.Push(op))) {
+        worker.Loop.Schedule(op); // Ring is full, the operation just isn't stealable
+        return;
+    }
+    std::atomic_thread_fence(std::memory_order_seq_cst); // Pairs with the one in ApplyStealable
+    if (!worker.DrainScheduled.exchange(true)) {
+        worker.Loop.Schedule(worker.Drain);
+    } else {
+        WakeupIdle(idx); // Worker is already behind, let somebody else help it
+    }
+}
+
+auto TLoopPool::Pop(std::size_t idx) noexcept -> TLoop::TOperation* {
+    auto& worker = *Workers[idx];
+    if (auto op = worker.Queue.Pop()) {
+        return op;
+    }
+    return worker.Inbox.Steal();
+}
+
+auto TLoopPool::Steal(std::size_t thief) noexcept -> TLoop::TOperation* {
+    for (std::size_t i = 1; i < Workers.size(); ++i) {
+        auto& victim = *Workers[(thief + i) % Workers.size()];
+        // Operations of other threads wait in the inbox, so a blocked victim doesn't keep them either
+        if (auto op = victim.Queue.Steal()) {
+            return op;
+        }
+        if (auto op = victim.Inbox.Steal()) {
+            return op;
+        }
+    }
+    return nullptr;
+}
+
+auto TLoopPool::HasStealable(std::size_t thief) const noexcept -> bool {
+    for (std::size_t i = 1; i < Workers.size(); ++i) {
+        auto& victim = *Workers[(thief + i) % Workers.size()];
+        if (!victim.Queue.Empty() || !victim.Inbox.Empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void TLoopPool::WakeupIdle(std::size_t busy) noexcept {
+    for (std::size_t i = 1; i < Workers.size(); ++i) {
+        auto idx = (busy + i) % Workers.size();
+        if (Workers[idx]->Idle.exchange(false)) {
+            ScheduleDrain(idx);
+            return;
+        }
+    }
+}
+
+void TLoopPool::ScheduleDrain(std::size_t idx) noexcept {
+    auto& worker = *Workers[idx];
+    if (!worker.DrainScheduled.exchange(true)) {
+        worker.Loop.Schedule(worker.Drain);
+    }
+}
+
+void TLoopPool::ApplyStealable(std::size_t idx) noexcept {
+    auto& worker = *Workers[idx];
+    worker.Idle.store(false, std::memory_order_relaxed);
+    for (std::size_t n = 0; n < DrainBudget; ++n) {
+        auto op = Pop(idx);
+        if (op == nullptr) {
+            op = Steal(idx);
+        }
+        if (op == nullptr) {
+            worker.Idle.store(true);
+            worker.DrainScheduled.store(false);
+            std::atomic_thread_fence(std::memory_order_seq_cst); // Either we see the push or its pusher sees us idle
+            if (!worker.Queue.Empty() || !worker.Inbox.Empty() || HasStealable(idx)) {
+                ScheduleDrain(idx);
+            }
+            return;
+        }
+        op->Apply();
+    }
+    worker.Loop.Schedule(worker.Drain); // Budget is exhausted, continue on the next iteration
+}
+
+TLoopPool::TWorker::TWorker(TLoopPool& pool, std::size_t idx)
+    : Loop(TLoopOptions{.BulkPool = &pool}) // Bulk work is spread over the sibling loops
+    , Finish(*this)
+    , Drain(pool, idx)
+    , Load{0}
+    , DrainScheduled{false}
+    , Idle{true}
+{}
+
+TLoopPool::TFinishOperation::TFinishOperation(TWorker& worker) noexcept
+    : Worker{&worker}
+{}
+
+void TLoopPool::TFinishOperation::Apply() noexcept {
+    if (Worker->Runner.Acquired()) {
+        Worker->Loop.finish();
+    }
+    Worker->Runner.Finish();
+}
+
+TLoopPool::TDrainOperation::TDrainOperation(TLoopPool& pool, std::size_t idx) noexcept
+    : Pool{&pool}, Idx{idx}
+{}
+
+void TLoopPool::TDrainOperation::Apply() noexcept {
+    Pool->ApplyStealable(Idx);
+}
+
+auto TLoopPool::TDomain::GetPool(const TLoopPool::TScheduler& sch) const noexcept -> TLoopPool& {
+    return *sch.Pool;
+}
+
+auto TLoopPool::TDomain::GetBalancing(const TLoopPool::TScheduler& sch) const noexcept -> EBalancing {
+    return sch.Balancing;
+}
+
+TLoopPool::TScheduler::TScheduler(TLoopPool& pool, EBalancing balancing) noexcept
+    : Pool{&pool}, Balancing{balancing}
+{}
+
+TLoopPool::TScheduler::TEnv::TEnv(TLoopPool& pool, EBalancing balancing) noexcept
+    : Pool{&pool}, Balancing{balancing}
+{}
+
+TLoopPool::TScheduler::TPoolEnv::TPoolEnv(TLoopPool& pool, EBalancing balancing) noexcept
+    : Pool{&pool}, Balancing{balancing}
+{}
+
+auto tag_invoke(stdexec::get_domain_t, const TLoopPool::TScheduler&) noexcept -> TLoopPool::TDomain {
+    return {};
+}
+
+auto tag_invoke(stdexec::get_domain_t, const TLoopPool::TScheduler::TEnv&) noexcept -> TLoopPool::TDomain {
+    return {};
+}
+
+auto tag_invoke(stdexec::get_scheduler_t, const TLoopPool::TScheduler::TPoolEnv& env) noexcept
+        -> TLoopPool::TScheduler {
+    return env.Pool->get_scheduler(env.Balancing);
+}
+
+auto tag_invoke(stdexec::get_domain_t, const TLoopPool::TScheduler::TPoolEnv&) noexcept -> TLoopPool::TDomain {
+    return {};
+}
+
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2024 Michael Guzov
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <uvexec/execution/loop_timer.hpp>
+#include <uvexec/uv_util/reqs.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+
+#ifdef __linux__
+#include <sys/timerfd.h>
+#include <unistd.h>
+#endif
+
+
+namespace NUvExec {
+
+#ifdef __linux__
+
+auto TLoopTimer::Init(uv_loop_t& loop, TCallback callback, void* data) -> NUvUtil::TUvError {
+    Callback = callback;
+    Data = data;
+    // uv_hrtime reads CLOCK_MONOTONIC as well, so deadlines are passed as they are
+    Fd = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (Fd < 0) {
+        return -errno;
+    }
+    if (auto err = NUvUtil::Init(Poll, loop, Fd); NUvUtil::IsError(err)) {
+        ::close(Fd);
+        Fd = -1;
+        return err;
+    }
+    Poll.data = this;
+    return 0;
+}
+
+auto TLoopTimer::Start(TLoopClock::time_point deadline) -> NUvUtil::TUvError {
+    // Zero disarms a timerfd, the earliest representable deadline is already in the past anyway
+    auto ns = std::max<TLoopClock::rep>(deadline.time_since_epoch().count(), 1);
+    itimerspec spec{};
+    spec.it_value.tv_sec = static_cast<time_t>(ns / 1'000'000'000);
+    spec.it_value.tv_nsec = static_cast<long>(ns % 1'000'000'000);
+    if (::timerfd_settime(Fd, TFD_TIMER_ABSTIME, &spec, nullptr) < 0) {
+        return -errno;
+    }
+    return NUvUtil::PollStart(Poll, UV_READABLE, OnReadable);
+}
+
+void TLoopTimer::Stop() noexcept {
+    NUvUtil::PollStop(Poll);
+}
+
+void TLoopTimer::Close() noexcept {
+    NUvUtil::Close(Poll);
+    ::close(Fd); // Closing the handle has already removed the descriptor from the backend
+    Fd = -1;
+}
+
+void TLoopTimer::OnReadable(uv_poll_t* poll, int, int) {
+    auto& timer = *static_cast<TLoopTimer*>(poll->data);
+    // One-shot like a uv timer, an idle timer must not keep the loop alive
+    NUvUtil::PollStop(timer.Poll);
+    std::uint64_t expirations;
+    [[maybe_unused]] auto _ = ::read(timer.Fd, &expirations, sizeof(expirations));
+    timer.Callback(timer.Data);
+}
+
+#else
+
+auto TLoopTimer::Init(uv_loop_t& loop, TCallback callback, void* data) -> NUvUtil::TUvError {
+    Callback = callback;
+    Data = data;
+    Timer.data = this;
+    return NUvUtil::Init(Timer, loop);
+}
+
+auto TLoopTimer::Start(TLoopClock::time_point deadline) -> NUvUtil::TUvError {
+    // Firing early is harmless, the callback just rearms the timer for the rest
+    auto timeout = std::max(std::chrono::ceil<std::chrono::milliseconds>(deadline - TLoopClock::now()),
+            std::chrono::milliseconds{0});
+    return NUvUtil::TimerStart(Timer, OnTimeout, static_cast<std::uint64_t>(timeout.count()), 0);
+}
+
+void TLoopTimer::Stop() noexcept {
+    NUvUtil::TimerStop(Timer);
+}
+
+void TLoopTimer::Close() noexcept {
+    NUvUtil::Close(Timer);
+}
+
+void TLoopTimer::OnTimeout(uv_timer_t* uvTimer) {
+    auto& timer = *static_cast<TLoopTimer*>(uvTimer->data);
+    timer.Callback(timer.Data);
+}
+
+#endif
+
+}
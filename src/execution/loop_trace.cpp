@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2024 Michael Guzov
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <uvexec/execution/loop_trace.hpp>
+#include <uvexec/execution/loop.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+
+namespace NUvExec {
+
+namespace {
+
+std::atomic_uint64_t NextBufferId{0};
+std::atomic_uint64_t NextThreadId{0};
+
+auto CurrentThreadId() noexcept -> std::uint64_t {
+    thread_local const std::uint64_t id = NextThreadId.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
+
+// Names are arbitrary strings, quotes, backslashes and control characters would break the JSON
+void WriteJsonString(std::ostream& out, const char* str) {
+    constexpr std::array<char, 16> hex{'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'};
+    out << '"';
+    for (auto s = str != nullptr ? str : ""; *s != '\0'; ++s) {
+        auto c = static_cast<unsigned char>(*s);
+        if (c == '"' || c == '\\') {
+            out << '\\' << *s;
+        } else if (c < 0x20) {
+            out << "\\u00" << hex[c >> 4] << hex[c & 0xf];
+        } else {
+            out << *s;
+        }
+    }
+    out << '"';
+}
+
+}
+
+TTraceBuffer::TTraceBuffer(std::size_t capacity)
+    : Slots(std::make_unique<TSlot[]>(std::bit_ceil(std::max<std::size_t>(capacity, 1))))
+    , Mask{std::bit_ceil(std::max<std::size_t>(capacity, 1)) - 1}
+    , Head{0}
+    , BufferId{NextBufferId.fetch_add(1, std::memory_order_relaxed)}
+{}
+
+void TTraceBuffer::Record(const TTraceEvent& event) noexcept {
+    auto idx = Head.fetch_add(1, std::memory_order_relaxed);
+    auto& slot = Slots[idx & Mask];
+    slot.Seq.store(2 * idx + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.Name.store(event.Name, std::memory_order_relaxed);
+    slot.BeginNs.store(event.BeginNs, std::memory_order_relaxed);
+    slot.EndNs.store(event.EndNs, std::memory_order_relaxed);
+    slot.ThreadId.store(event.ThreadId, std::memory_order_relaxed);
+    slot.Seq.store(2 * idx + 2, std::memory_order_release);
+}
+
+auto TTraceBuffer::Snapshot() const -> std::vector<TTraceEvent> {
+    auto head = Head.load(std::memory_order_acquire);
+    auto capacity = Mask + 1;
+    auto first = head > capacity ? head - capacity : 0;
+    std::vector<TTraceEvent> events;
+    events.reserve(head - first);
+    for (auto idx = first; idx < head; ++idx) {
+        auto& slot = Slots[idx & Mask];
+        auto seq = slot.Seq.load(std::memory_order_acquire);
+        if (seq != 2 * idx + 2) {
+            continue; // Not written yet or already overwritten by a newer event
+        }
+        TTraceEvent event{
+            slot.Name.load(std::memory_order_relaxed),
+            slot.BeginNs.load(std::memory_order_relaxed),
+            slot.EndNs.load(std::memory_order_relaxed),
+            slot.ThreadId.load(std::memory_order_relaxed)};
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.Seq.load(std::memory_order_relaxed) == seq) {
+            events.push_back(event);
+        }
+    }
+    return events;
+}
+
+auto TTraceBuffer::Id() const noexcept -> std::uint64_t {
+    return BufferId;
+}
+
+void WriteChromeTrace(std::ostream& out, std::span<const TTraceBuffer* const> traces) {
+    // Operations overlap on the same thread, so they are written as async slices with unique ids
+    out << R"({"displayTimeUnit":"ns","traceEvents":[)";
+    std::uint64_t id = 0;
+    for (auto trace : traces) {
+        if (trace == nullptr) {
+            continue;
+        }
+        for (auto& event : trace->Snapshot()) {
+            for (auto [phase, ns] : {std::pair{'b', event.BeginNs}, std::pair{'e', event.EndNs}}) {
+                out << (id == 0 && phase == 'b' ? "" : ",")
+                    << R"({"cat":"uvexec","name":)";
+                WriteJsonString(out, event.Name);
+                out << R"(,"ph":")" << phase
+                    << R"(","id":)" << id
+                    << R"(,"pid":)" << trace->Id()
+                    << R"(,"tid":)" << event.ThreadId
+                    << R"(,"ts":)" << ns / 1000 << '.' << ns % 1000 / 100 << ns % 100 / 10 << ns % 10
+                    << '}';
+            }
+            ++id;
+        }
+    }
+    out << "]}";
+}
+
+#ifdef UVEXEC_ENABLE_TRACING
+
+void TTraceSpan::Begin(uv_loop_t& loop, const char* name) noexcept {
+    Buffer = static_cast<TLoop*>(loop.data)->Trace.get();
+    Name = name;
+    BeginNs = ::uv_hrtime();
+}
+
+void TTraceSpan::End() noexcept {
+    if (Buffer != nullptr) {
+        Buffer->Record(TTraceEvent{Name, BeginNs, ::uv_hrtime(), CurrentThreadId()});
+        Buffer = nullptr;
+    }
+}
+
+#endif
+
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2024 Michael Guzov
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <uvexec/execution/loop_watchdog.hpp>
+
+
+namespace NUvExec {
+
+TLoopWatchdog::TLoopWatchdog(TLoop& loop, TLoopWatchdogOptions options)
+    : Loop{&loop}
+    , Options(std::move(options))
+    , Probe(*this)
+    , Stalls{0}
+    , StallReported{false}
+    , Stopped{false}
+    , Thread(&TLoopWatchdog::Watch, this)
+{}
+
+TLoopWatchdog::~TLoopWatchdog() {
+    {
+        std::lock_guard lock(Mtx);
+        Stopped = true;
+    }
+    StopCv.notify_one();
+    Thread.join();
+    // The loop holds the probe until it's applied, drained here so that it never refers to a dead watchdog
+    std::unique_lock lock(Mtx);
+    ProbeCv.wait(lock, [this]() noexcept {
+        return !Probe.Pending.load(std::memory_order_relaxed);
+    });
+}
+
+auto TLoopWatchdog::GetLags() const noexcept -> const TLog2Histogram& {
+    return Probe.LagsNs;
+}
+
+auto TLoopWatchdog::GetLastLag() const noexcept -> std::chrono::nanoseconds {
+    return std::chrono::nanoseconds(Probe.LastLagNs.load(std::memory_order_relaxed));
+}
+
+auto TLoopWatchdog::GetStallsCount() const noexcept -> std::uint64_t {
+    return Stalls.load(std::memory_order_relaxed);
+}
+
+void TLoopWatchdog::Watch() {
+    std::unique_lock lock(Mtx);
+    while (!Stopped) {
+        auto now = TClock::now().time_since_epoch().count();
+        if (!Probe.Pending.load(std::memory_order_acquire)) {
+            StallReported = false;
+            Probe.SentAt.store(now, std::memory_order_relaxed);
+            Probe.Pending.store(true, std::memory_order_relaxed);
+            Loop->Schedule(Probe);
+        } else if (auto stuck = TClock::duration(now - Probe.SentAt.load(std::memory_order_relaxed));
+                   !StallReported && stuck >= Options.StallThreshold) {
+            StallReported = true;
+            Stalls.fetch_add(1, std::memory_order_relaxed);
+            if (Options.OnStall) {
+                lock.unlock();
+                Options.OnStall(*Loop, stuck);
+                lock.lock();
+            }
+        }
+        StopCv.wait_for(lock, Options.ProbePeriod, [this]() noexcept {
+            return Stopped;
+        });
+    }
+}
+
+TLoopWatchdog::TProbe::TProbe(TLoopWatchdog& watchdog) noexcept
+    : Watchdog{&watchdog}
+{}
+
+void TLoopWatchdog::TProbe::Apply() noexcept {
+    auto lag = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            TClock::duration(TClock::now().time_since_epoch().count() - SentAt.load(std::memory_order_relaxed)));
+    LagsNs.Record(lag.count());
+    LastLagNs.store(lag.count(), std::memory_order_relaxed);
+    std::lock_guard lock(Watchdog->Mtx); // Nothing is touched after it's released, the destructor may be waiting
+    Pending.store(false, std::memory_order_release);
+    Watchdog->ProbeCv.notify_one();
+}
+
+}
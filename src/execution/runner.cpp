@@ -23,10 +23,11 @@ bool TRunner::Finished() const noexcept {
 }
 
 bool TRunner::AcquireIfNotFinished() noexcept {
-    if (Awakenings.load(std::memory_order_relaxed) != 0) {
-        Acq = true;
+    if (Awakenings.load(std::memory_order_relaxed) == 0) {
+        return false; // May have led before, but a finished runner has nobody to run the loop for
     }
-    return Acq;
+    Acq = true;
+    return true;
 }
 
 bool TRunner::Acquired() const noexcept {
@@ -34,7 +35,10 @@ bool TRunner::Acquired() const noexcept {
 }
 
 void TRunner::Wakeup() noexcept {
-    Awakenings.fetch_add(1, std::memory_order_relaxed);
+    // Finished is final, counting a wakeup on top of it would make the runner run the loop again for nobody
+    auto wakeups = Awakenings.load(std::memory_order_relaxed);
+    while (wakeups != 0 && !Awakenings.compare_exchange_weak(
+            wakeups, wakeups + 1, std::memory_order_release, std::memory_order_relaxed)) {}
     Awakenings.notify_one();
 }
 
@@ -44,12 +48,24 @@ void TRunner::Finish() noexcept {
 }
 
 void TRunner::Wait() noexcept {
-    auto wakeups = Awakenings.load(std::memory_order_relaxed);
+    auto wakeups = Awakenings.load(std::memory_order_acquire);
+    if (Promoted.load(std::memory_order_relaxed)) {
+        return; // Promoted before we started waiting
+    }
     while (wakeups != 0 && Awakenings.load(std::memory_order_relaxed) == wakeups) {
         Awakenings.wait(wakeups, std::memory_order_relaxed);
     }
 }
 
+void TRunner::Promote() noexcept {
+    Promoted.store(true, std::memory_order_release);
+    Wakeup();
+}
+
+bool TRunner::TakePromotion() noexcept {
+    return Promoted.exchange(false, std::memory_order_acquire);
+}
+
 void TRunnersQueue::Add(NUvExec::TRunner& runner) noexcept {
     Runners.Add(runner);
 }
@@ -58,14 +74,15 @@ void TRunnersQueue::Erase(NUvExec::TRunner& runner) {
     Runners.Erase(runner);
 }
 
-void TRunnersQueue::WakeupNext() noexcept {
+bool TRunnersQueue::PromoteNext() noexcept {
     while (!Runners.Empty()) {
         auto& next = Runners.Pop();
         if (!next.Finished()) {
-            next.Wakeup();
-            break;
+            next.Promote();
+            return true;
         }
     }
+    return false;
 }
 
 }
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2024 Michael Guzov
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <uvexec/execution/steal_deque.hpp>
+
+
+namespace NUvExec {
+
+auto TStealDeque::Push(TLoop::TOperation& op) noexcept -> bool {
+    auto bottom = Bottom.load(std::memory_order_relaxed);
+    auto top = Top.load(std::memory_order_acquire);
+    if (bottom - top >= static_cast<std::int64_t>(Capacity)) {
+        return false;
+    }
+    Ring[bottom & Mask].store(&op, std::memory_order_relaxed);
+    Bottom.store(bottom + 1, std::memory_order_release); // Publishes the slot to thieves
+    return true;
+}
+
+auto TStealDeque::Pop() noexcept -> TLoop::TOperation* {
+    auto bottom = Bottom.load(std::memory_order_relaxed) - 1;
+    Bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst); // Either a thief sees the reservation or we see its steal
+    auto top = Top.load(std::memory_order_relaxed);
+    if (top > bottom) {
+        Bottom.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    auto op = Ring[bottom & Mask].load(std::memory_order_relaxed);
+    if (top == bottom) {
+        // The last operation, thieves may race for it as well
+        if (!Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            op = nullptr;
+        }
+        Bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return op;
+}
+
+auto TStealDeque::Steal() noexcept -> TLoop::TOperation* {
+    auto top = Top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto bottom = Bottom.load(std::memory_order_acquire);
+    if (top >= bottom) {
+        return nullptr;
+    }
+    auto op = Ring[top & Mask].load(std::memory_order_relaxed);
+    if (!Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    return op;
+}
+
+auto TStealDeque::Size() const noexcept -> std::size_t {
+    auto bottom = Bottom.load(std::memory_order_acquire);
+    auto top = Top.load(std::memory_order_acquire);
+    return bottom > top ? static_cast<std::size_t>(bottom - top) : 0;
+}
+
+auto TStealDeque::Empty() const noexcept -> bool {
+    return Size() == 0;
+}
+
+TStealRing::TStealRing() noexcept {
+    for (std::size_t i = 0; i < Capacity; ++i) {
+        Slots[i].Seq.store(i, std::memory_order_relaxed);
+    }
+}
+
+auto TStealRing::Push(TLoop::TOperation& op) noexcept -> bool {
+    auto pos = Tail.load(std::memory_order_relaxed);
+    while (true) {
+        auto& slot = Slots[pos & Mask];
+        auto diff = static_cast<std::ptrdiff_t>(slot.Seq.load(std::memory_order_acquire) - pos);
+        if (diff == 0) {
+            if (Tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                slot.Op = &op;
+                slot.Seq.store(pos + 1, std::memory_order_release); // Publishes the slot to consumers
+                return true;
+            }
+        } else if (diff < 0) {
+            return false; // The slot still holds an operation of the previous lap
+        } else {
+            pos = Tail.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+auto TStealRing::Steal() noexcept -> TLoop::TOperation* {
+    auto pos = Head.load(std::memory_order_relaxed);
+    while (true) {
+        auto& slot = Slots[pos & Mask];
+        auto diff = static_cast<std::ptrdiff_t>(slot.Seq.load(std::memory_order_acquire) - (pos + 1));
+        if (diff == 0) {
+            if (Head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                auto op = slot.Op;
+                slot.Seq.store(pos + Capacity, std::memory_order_release); // Hands the slot to the next lap
+                return op;
+            }
+        } else if (diff < 0) {
+            return nullptr; // Empty, or its producer hasn't published the slot yet
+        } else {
+            pos = Head.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+auto TStealRing::Empty() const noexcept -> bool {
+    return Head.load(std::memory_order_acquire) == Tail.load(std::memory_order_acquire);
+}
+
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2024 Michael Guzov
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <uvexec/execution/timer_wheel.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+
+namespace NUvExec {
+
+TTimerWheel::TTimerWheel(std::uint64_t now) noexcept
+    : Current{now}
+{}
+
+void TTimerWheel::Insert(TTimer& timer) noexcept {
+    ++Count;
+    Place(timer);
+}
+
+auto TTimerWheel::Cancel(TTimer& timer) noexcept -> bool {
+    if (timer.List == NotScheduled) {
+        return false;
+    }
+    auto& list = Lists[timer.List];
+    list.Erase(timer);
+    if (timer.List < Overflow && list.Empty()) {
+        Occupied[timer.List / SlotsCount] &= ~(std::uint64_t{1} << (timer.List % SlotsCount));
+    }
+    timer.List = NotScheduled;
+    --Count;
+    return true;
+}
+
+void TTimerWheel::Advance(std::uint64_t now) noexcept {
+    auto prev = std::exchange(Current, std::max(Current, now));
+    for (std::size_t level = 0; level < Levels; ++level) {
+        auto oldPos = prev >> (level * SlotBits);
+        auto newPos = Current >> (level * SlotBits);
+        if (oldPos == newPos) {
+            break; // Higher levels haven't moved either
+        }
+        auto steps = std::min<std::uint64_t>(newPos - oldPos, SlotsCount);
+        for (std::uint64_t i = 1; i <= steps; ++i) {
+            Cascade(static_cast<std::uint16_t>(level * SlotsCount + ((oldPos + i) & SlotMask)));
+        }
+    }
+    if ((prev >> (Levels * SlotBits)) != (Current >> (Levels * SlotBits))) {
+        Cascade(Overflow);
+    }
+    while (!Lists[Due].Empty()) {
+        Link(Lists[Due].Pop(), Expired);
+    }
+}
+
+auto TTimerWheel::PopExpired() noexcept -> TTimer* {
+    if (Lists[Expired].Empty()) {
+        return nullptr;
+    }
+    auto& timer = Lists[Expired].Pop();
+    timer.List = NotScheduled;
+    --Count;
+    return &timer;
+}
+
+auto TTimerWheel::NextExpiry() const noexcept -> std::uint64_t {
+    if (!Lists[Due].Empty() || !Lists[Expired].Empty()) {
+        return Current;
+    }
+    auto next = Lists[Overflow].Empty() ? Never : ((Current >> (Levels * SlotBits)) + 1) << (Levels * SlotBits);
+    for (std::size_t level = 0; level < Levels; ++level) {
+        if (Occupied[level] == 0) {
+            continue;
+        }
+        auto pos = Current >> (level * SlotBits);
+        // Occupied slots are always ahead of the current one, so the first of them after it comes first
+        auto ahead = std::countr_zero(std::rotr(Occupied[level], static_cast<int>((pos + 1) & SlotMask)));
+        next = std::min(next, (pos + 1 + static_cast<std::uint64_t>(ahead)) << (level * SlotBits));
+    }
+    return next;
+}
+
+auto TTimerWheel::Now() const noexcept -> std::uint64_t {
+    return Current;
+}
+
+auto TTimerWheel::Size() const noexcept -> std::size_t {
+    return Count;
+}
+
+auto TTimerWheel::Empty() const noexcept -> bool {
+    return Count == 0;
+}
+
+void TTimerWheel::Place(TTimer& timer) noexcept {
+    if (timer.Deadline <= Current) {
+        Link(timer, Due);
+        return;
+    }
+    auto level = static_cast<std::size_t>(std::bit_width(timer.Deadline ^ Current) - 1) / SlotBits;
+    if (level >= Levels) {
+        Link(timer, Overflow);
+        return;
+    }
+    auto slot = (timer.Deadline >> (level * SlotBits)) & SlotMask;
+    Occupied[level] |= std::uint64_t{1} << slot;
+    Link(timer, static_cast<std::uint16_t>(level * SlotsCount + slot));
+}
+
+void TTimerWheel::Link(TTimer& timer, std::uint16_t list) noexcept {
+    timer.List = list;
+    Lists[list].PushBack(timer);
+}
+
+void TTimerWheel::Cascade(std::uint16_t list) noexcept {
+    // Detached first, a full turn may place timers back to the very same slot
+    auto timers = std::exchange(Lists[list], {});
+    if (list < Overflow) {
+        Occupied[list / SlotsCount] &= ~(std::uint64_t{1} << (list % SlotsCount));
+    }
+    while (!timers.Empty()) {
+        Place(timers.Pop());
+    }
+}
+
+}
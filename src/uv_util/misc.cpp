@@ -17,6 +17,8 @@
 
 #include <uvexec/uv_util/safe_uv.hpp>
 
+#include <vector>
+
 
 auto NUvUtil::NDetail::GetData(const uv_handle_t* handle) -> void* {
     return ::uv_handle_get_data(handle);
@@ -36,3 +38,19 @@ auto NUvUtil::CopyAddress(const sockaddr* from, sockaddr_in& to) -> TUvError {
 auto NUvUtil::CopyAddress(const sockaddr* from, sockaddr_in6& to) -> TUvError {
     return ::UvCopyIn6Address(from, &to);
 }
+
+auto NUvUtil::SetCurrentThreadAffinity(std::span<const std::size_t> cpus) -> TUvError {
+    auto size = ::uv_cpumask_size();
+    if (IsError(size)) {
+        return size;
+    }
+    std::vector<char> mask(static_cast<std::size_t>(size), 0);
+    for (auto cpu : cpus) {
+        if (cpu >= mask.size()) {
+            return UV_EINVAL;
+        }
+        mask[cpu] = 1;
+    }
+    auto self = ::uv_thread_self();
+    return ::uv_thread_setaffinity(&self, mask.data(), nullptr, mask.size());
+}
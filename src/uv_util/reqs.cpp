@@ -28,6 +28,22 @@ auto Init(uv_signal_t& signal, uv_loop_t& loop) -> TUvError {
     return ::uv_signal_init(&loop, &signal);
 }
 
+auto Init(uv_idle_t& idle, uv_loop_t& loop) -> TUvError {
+    return ::uv_idle_init(&loop, &idle);
+}
+
+auto Init(uv_check_t& check, uv_loop_t& loop) -> TUvError {
+    return ::uv_check_init(&loop, &check);
+}
+
+auto Init(uv_prepare_t& prepare, uv_loop_t& loop) -> TUvError {
+    return ::uv_prepare_init(&loop, &prepare);
+}
+
+auto Init(uv_poll_t& poll, uv_loop_t& loop, int fd) -> TUvError {
+    return ::uv_poll_init(&loop, &poll, fd);
+}
+
 auto Fire(uv_async_t& req) -> TUvError {
     return ::uv_async_send(&req);
 }
@@ -52,6 +68,38 @@ auto SignalStop(uv_signal_t& req) -> TUvError {
     return ::uv_signal_stop(&req);
 }
 
+auto IdleStart(uv_idle_t& req, uv_idle_cb cb) -> TUvError {
+    return ::uv_idle_start(&req, cb);
+}
+
+auto IdleStop(uv_idle_t& req) -> TUvError {
+    return ::uv_idle_stop(&req);
+}
+
+auto CheckStart(uv_check_t& req, uv_check_cb cb) -> TUvError {
+    return ::uv_check_start(&req, cb);
+}
+
+auto CheckStop(uv_check_t& req) -> TUvError {
+    return ::uv_check_stop(&req);
+}
+
+auto PrepareStart(uv_prepare_t& req, uv_prepare_cb cb) -> TUvError {
+    return ::uv_prepare_start(&req, cb);
+}
+
+auto PrepareStop(uv_prepare_t& req) -> TUvError {
+    return ::uv_prepare_stop(&req);
+}
+
+auto PollStart(uv_poll_t& req, int events, uv_poll_cb cb) -> TUvError {
+    return ::uv_poll_start(&req, events, cb);
+}
+
+auto PollStop(uv_poll_t& req) -> TUvError {
+    return ::uv_poll_stop(&req);
+}
+
 auto Bind(uv_tcp_t& tcp, const sockaddr_in& addr) -> TUvError {
     return ::UvTcpInBind(&tcp, &addr);
 }
@@ -156,4 +204,16 @@ void Close(uv_idle_t& handle, uv_close_cb cb) {
     ::UvIdleClose(&handle, cb);
 }
 
+void Close(uv_check_t& handle, uv_close_cb cb) {
+    ::UvCheckClose(&handle, cb);
+}
+
+void Close(uv_prepare_t& handle, uv_close_cb cb) {
+    ::UvPrepareClose(&handle, cb);
+}
+
+void Close(uv_poll_t& handle, uv_close_cb cb) {
+    ::UvPollClose(&handle, cb);
+}
+
 }
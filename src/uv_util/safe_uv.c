@@ -128,3 +128,15 @@ void UvUdpClose(uv_udp_t* handle, uv_close_cb close_cb) {
 void UvIdleClose(uv_idle_t* handle, uv_close_cb close_cb) {
     uv_close((uv_handle_t*)handle, close_cb);
 }
+
+void UvCheckClose(uv_check_t* handle, uv_close_cb close_cb) {
+    uv_close((uv_handle_t*)handle, close_cb);
+}
+
+void UvPrepareClose(uv_prepare_t* handle, uv_close_cb close_cb) {
+    uv_close((uv_handle_t*)handle, close_cb);
+}
+
+void UvPollClose(uv_poll_t* handle, uv_close_cb close_cb) {
+    uv_close((uv_handle_t*)handle, close_cb);
+}
@@ -17,13 +17,19 @@
 #include <catch2/catch.hpp>
 
 #include <uvexec/execution/loop.hpp>
+#include <uvexec/execution/loop_watchdog.hpp>
+#include <uvexec/execution/task.hpp>
 #include <uvexec/algorithms/schedule.hpp>
+#include <uvexec/algorithms/spawn.hpp>
+#include <uvexec/algorithms/transfer.hpp>
 
 #include <exec/single_thread_context.hpp>
 #include <exec/task.hpp>
 #include <exec/async_scope.hpp>
+#include <exec/env.hpp>
 
 #include <latch>
+#include <sstream>
 
 
 using namespace NUvExec;
@@ -173,6 +179,43 @@ TEST_CASE("Transfer to Loop", "[loop][mt]") {
     REQUIRE(threadId == std::this_thread::get_id());
 }
 
+TEST_CASE("Transfer between loops", "[loop][mt]") {
+    constexpr int iterations = 1000;
+
+    TLoop first;
+    TLoop second;
+    std::thread t([&] {
+        second.run();
+    });
+    int counter{0};
+    std::atomic_int misplaced{0};
+
+    exec::async_scope scope;
+    stdexec::sync_wait(stdexec::schedule(first.get_scheduler()) | stdexec::then([&]() noexcept {
+        for (int i = 0; i < iterations; ++i) {
+            scope.spawn(stdexec::schedule(first.get_scheduler())
+                    | stdexec::then([] {
+                        return std::this_thread::get_id();
+                    })
+                    | stdexec::transfer(second.get_scheduler())
+                    | stdexec::then([&](std::thread::id sourceId) noexcept {
+                        if (sourceId == std::this_thread::get_id() || t.get_id() != std::this_thread::get_id()) {
+                            misplaced.fetch_add(1);
+                        }
+                        ++counter;
+                    }));
+        }
+    }));
+    stdexec::sync_wait(scope.on_empty() | stdexec::transfer(first.get_scheduler()));
+    stdexec::sync_wait(stdexec::schedule(second.get_scheduler()) | stdexec::then([&]() noexcept {
+        second.finish();
+    }));
+    t.join();
+
+    REQUIRE(counter == iterations);
+    REQUIRE(misplaced.load() == 0);
+}
+
 TEST_CASE("Parallel schedule", "[loop][mt]") {
     constexpr int iterations = 1000;
 
@@ -236,6 +279,421 @@ TEST_CASE("High parallel schedule", "[loop][mt]") {
     REQUIRE(counter == threadsCount * iterations);
 }
 
+TEST_CASE("Bounded batch", "[loop]") {
+    constexpr int iterations = 1000;
+
+    TLoop uvLoop(TLoopOptions{.BatchBudget = GENERATE(as<std::size_t>{}, 1, 7, 1024)});
+    std::vector<int> order;
+    order.reserve(iterations);
+
+    exec::async_scope scope;
+    for (int i = 0; i < iterations; ++i) {
+        scope.spawn(stdexec::schedule(uvLoop.get_scheduler()) | stdexec::then([&order, i]() noexcept {
+            order.push_back(i);
+        }));
+    }
+    stdexec::sync_wait(
+            stdexec::schedule(uvLoop.get_scheduler())
+            | stdexec::let_value([&]() noexcept {
+                return scope.on_empty();
+            }));
+
+    REQUIRE(order.size() == iterations);
+    REQUIRE(std::is_sorted(order.begin(), order.end()));
+}
+
+TEST_CASE("Schedule from loop thread", "[loop]") {
+    constexpr int iterations = 1000;
+
+    TLoop uvLoop;
+    auto threadId = std::this_thread::get_id();
+    std::vector<int> order;
+    order.reserve(iterations);
+
+    exec::async_scope scope;
+    stdexec::sync_wait(
+            stdexec::schedule(uvLoop.get_scheduler())
+            | stdexec::let_value([&]() noexcept {
+                for (int i = 0; i < iterations; ++i) {
+                    scope.spawn(stdexec::schedule(uvLoop.get_scheduler()) | stdexec::then([&, i]() noexcept {
+                        REQUIRE(threadId == std::this_thread::get_id());
+                        order.push_back(i);
+                    }));
+                }
+                return scope.on_empty();
+            }));
+
+    REQUIRE(order.size() == iterations);
+    REQUIRE(std::is_sorted(order.begin(), order.end()));
+}
+
+TEST_CASE("Spinning loop", "[loop][mt]") {
+    constexpr int iterations = 1000;
+
+    TLoop uvLoop(TLoopOptions{.SpinBudget = GENERATE(1us, 100us, 10ms)});
+    exec::single_thread_context ctx;
+    int counter{0};
+
+    exec::async_scope scope;
+    for (int i = 0; i < iterations; ++i) {
+        scope.spawn(stdexec::schedule(ctx.get_scheduler())
+                | stdexec::transfer(uvLoop.get_scheduler())
+                | stdexec::then([&]() noexcept {
+                    ++counter;
+                }));
+    }
+    stdexec::sync_wait(
+            stdexec::schedule(uvLoop.get_scheduler())
+            | stdexec::let_value([&]() noexcept {
+                return scope.on_empty();
+            }));
+
+    REQUIRE(counter == iterations);
+}
+
+TEST_CASE("Spinning loop wakes up for idle work", "[loop][mt]") {
+    constexpr int iterations = 1000;
+
+    TLoop uvLoop(TLoopOptions{.SpinBudget = GENERATE(1us, 10us)});
+    exec::single_thread_context ctx;
+    int counter{0};
+
+    // Every push races with the loop giving up spinning, a lost wakeup leaves it blocked in poll forever
+    for (int i = 0; i < iterations; ++i) {
+        stdexec::sync_wait(stdexec::schedule(ctx.get_scheduler())
+                | stdexec::then([i]() noexcept {
+                    std::this_thread::sleep_for(std::chrono::microseconds(i % 20));
+                })
+                | stdexec::transfer(uvLoop.get_idle_scheduler())
+                | stdexec::then([&]() noexcept {
+                    ++counter;
+                }));
+    }
+
+    REQUIRE(counter == iterations);
+}
+
+TEST_CASE("Batched schedule", "[loop][mt]") {
+    constexpr int iterations = 1000;
+
+    TLoop uvLoop(TLoopOptions{.CollectMetrics = true});
+    exec::single_thread_context ctx;
+    int counter{0};
+    std::uint64_t scheduledInBatch{0};
+
+    exec::async_scope scope;
+    stdexec::sync_wait(stdexec::schedule(ctx.get_scheduler()) | stdexec::then([&]() noexcept {
+        TLoop::TScheduleBatch batch(uvLoop);
+        for (int i = 0; i < iterations; ++i) {
+            scope.spawn(stdexec::schedule(uvLoop.get_scheduler(i % 2 ? EPriority::High : EPriority::Low))
+                    | stdexec::then([&]() noexcept {
+                        ++counter;
+                    }), batch.get_env());
+        }
+        scheduledInBatch = uvLoop.GetMetrics()->Scheduled.load();
+        // Schedules without the batch environment aren't held back by it
+        stdexec::sync_wait(stdexec::schedule(uvLoop.get_scheduler()));
+    }));
+    REQUIRE(scheduledInBatch == 0);
+    REQUIRE(uvLoop.GetMetrics()->Scheduled.load() == iterations + 1);
+
+    stdexec::sync_wait(scope.on_empty() | stdexec::transfer(uvLoop.get_scheduler()));
+    REQUIRE(counter == iterations);
+}
+
+TEST_CASE("Schedule after batch submit", "[loop][mt]") {
+    TLoop uvLoop(TLoopOptions{.CollectMetrics = true});
+    exec::single_thread_context ctx;
+    int counter{0};
+    std::uint64_t scheduledAfterSubmit{0};
+
+    exec::async_scope scope;
+    stdexec::sync_wait(stdexec::schedule(ctx.get_scheduler()) | stdexec::then([&]() noexcept {
+        TLoop::TScheduleBatch batch(uvLoop);
+        scope.spawn(stdexec::schedule(uvLoop.get_scheduler())
+                | stdexec::let_value([&]() noexcept {
+                    // Started on the loop thread once the batch is submitted and likely destroyed
+                    return stdexec::schedule(uvLoop.get_scheduler()) | stdexec::then([&]() noexcept {
+                        ++counter;
+                    });
+                }), batch.get_env());
+        batch.Submit();
+        // Submitted batch doesn't hold back operations started with its environment
+        scope.spawn(stdexec::schedule(uvLoop.get_scheduler()) | stdexec::then([&]() noexcept {
+            ++counter;
+        }), batch.get_env());
+        scheduledAfterSubmit = uvLoop.GetMetrics()->Scheduled.load();
+    }));
+    REQUIRE(scheduledAfterSubmit == 2);
+
+    stdexec::sync_wait(scope.on_empty() | stdexec::transfer(uvLoop.get_scheduler()));
+    REQUIRE(counter == 2);
+}
+
+TEST_CASE("Priority lanes", "[loop]") {
+    constexpr int iterations = 10;
+
+    TLoop uvLoop;
+    std::vector<EPriority> order;
+
+    exec::async_scope scope;
+    for (auto priority : {EPriority::Low, EPriority::Normal, EPriority::High}) {
+        for (int i = 0; i < iterations; ++i) {
+            scope.spawn(stdexec::schedule(uvLoop.get_scheduler(priority)) | stdexec::then([&order, priority]() noexcept {
+                order.push_back(priority);
+            }));
+        }
+    }
+    stdexec::sync_wait(
+            stdexec::schedule(uvLoop.get_scheduler(EPriority::Low))
+            | stdexec::let_value([&]() noexcept {
+                return scope.on_empty();
+            }));
+
+    REQUIRE(order.size() == 3 * iterations);
+    REQUIRE(std::is_sorted(order.begin(), order.end()));
+}
+
+TEST_CASE("Low priority isn't starved", "[loop]") {
+    constexpr int iterations = 1000;
+
+    TLoop uvLoop(TLoopOptions{.BatchBudget = GENERATE(as<std::size_t>{}, 3, 7, 64)});
+    int high{0};
+    int highBeforeLow{-1};
+
+    exec::async_scope scope;
+    for (int i = 0; i < iterations; ++i) {
+        scope.spawn(stdexec::schedule(uvLoop.get_scheduler(EPriority::High)) | stdexec::then([&]() noexcept {
+            ++high;
+        }));
+    }
+    scope.spawn(stdexec::schedule(uvLoop.get_scheduler(EPriority::Low)) | stdexec::then([&]() noexcept {
+        highBeforeLow = high;
+    }));
+    stdexec::sync_wait(
+            stdexec::schedule(uvLoop.get_scheduler())
+            | stdexec::let_value([&]() noexcept {
+                return scope.on_empty();
+            }));
+
+    REQUIRE(high == iterations);
+    REQUIRE(highBeforeLow >= 0);
+    REQUIRE(highBeforeLow < iterations);
+}
+
+TEST_CASE("Idle scheduler", "[loop]") {
+    TLoop uvLoop;
+    std::vector<int> order;
+
+    exec::async_scope scope;
+    auto push = [&](int i) {
+        return stdexec::then([&order, i]() noexcept {
+            order.push_back(i);
+        });
+    };
+    stdexec::sync_wait(
+            stdexec::schedule(uvLoop.get_scheduler())
+            | stdexec::let_value([&]() noexcept {
+                scope.spawn(stdexec::schedule(uvLoop.get_idle_scheduler()) | push(0));
+                for (int i = 1; i <= 3; ++i) {
+                    scope.spawn(stdexec::schedule(uvLoop.get_scheduler(EPriority::Low)) | push(i));
+                }
+                return scope.on_empty();
+            }));
+
+    REQUIRE(order == std::vector{1, 2, 3, 0});
+
+    exec::single_thread_context ctx;
+    stdexec::sync_wait(
+            stdexec::schedule(ctx.get_scheduler())
+            | stdexec::transfer(uvLoop.get_idle_scheduler())
+            | push(4));
+    REQUIRE(order.back() == 4);
+}
+
+TEST_CASE("Deadline scheduler", "[loop]") {
+    TLoop uvLoop;
+    auto now = exec::now(uvLoop.get_scheduler());
+    std::vector<int> order;
+    int stopped{0};
+
+    auto job = [&](int deadline) {
+        return exec::write(
+                stdexec::schedule(uvLoop.get_deadline_scheduler()) | stdexec::then([&order, deadline]() noexcept {
+                    order.push_back(deadline);
+                }),
+                exec::with(uvexec::get_deadline, now + std::chrono::seconds(deadline)));
+    };
+
+    exec::async_scope scope;
+    for (int deadline : {30, 10, 20}) {
+        scope.spawn(job(deadline));
+    }
+    scope.spawn(job(-1) | stdexec::upon_stopped([&]() noexcept {
+        ++stopped;
+    }));
+    stdexec::sync_wait(
+            stdexec::schedule(uvLoop.get_scheduler())
+            | stdexec::let_value([&]() noexcept {
+                return scope.on_empty();
+            }));
+
+    REQUIRE(order == std::vector{10, 20, 30});
+    REQUIRE(stopped == 1);
+
+    STATIC_REQUIRE(std::same_as<TLoop::TDeadlineScheduler, decltype(stdexec::get_completion_scheduler<
+            stdexec::set_value_t>(stdexec::get_env(stdexec::schedule(uvLoop.get_deadline_scheduler()))))>);
+    exec::single_thread_context ctx;
+    auto [threadId] = stdexec::sync_wait(stdexec::schedule(ctx.get_scheduler())
+            | stdexec::transfer(uvLoop.get_deadline_scheduler())
+            | stdexec::then([] {
+                return std::this_thread::get_id();
+            })).value();
+    REQUIRE(threadId == std::this_thread::get_id());
+}
+
+TEST_CASE("Admission control", "[loop]") {
+    constexpr int highWaterMark = 10;
+
+    TLoop uvLoop(TLoopOptions{.CollectMetrics = true, .HighWaterMark = highWaterMark});
+    int executed{0};
+    int rejected{0};
+
+    exec::async_scope scope;
+    for (int i = 0; i < 2 * highWaterMark; ++i) {
+        scope.spawn(stdexec::schedule(uvLoop.get_scheduler())
+                | stdexec::then([&]() noexcept {
+                    ++executed;
+                })
+                | stdexec::upon_stopped([&]() noexcept {
+                    ++rejected;
+                }));
+    }
+    REQUIRE(rejected == highWaterMark);
+    REQUIRE(uvLoop.GetBacklog() == highWaterMark);
+    REQUIRE(uvLoop.GetMetrics()->Rejected.load() == highWaterMark);
+
+    stdexec::sync_wait(scope.on_empty() | stdexec::transfer(uvLoop.get_scheduler()));
+    REQUIRE(executed == highWaterMark);
+    REQUIRE(uvLoop.GetBacklog() == 0);
+
+    {
+        TLoop::TScheduleBatch batch(uvLoop);
+        for (int i = 0; i < 2 * highWaterMark; ++i) {
+            scope.spawn(stdexec::schedule(uvLoop.get_scheduler())
+                    | stdexec::then([&]() noexcept {
+                        ++executed;
+                    })
+                    | stdexec::upon_stopped([&]() noexcept {
+                        ++rejected;
+                    }), batch.get_env());
+        }
+    }
+    REQUIRE(rejected == 2 * highWaterMark);
+    REQUIRE(uvLoop.GetBacklog() == highWaterMark);
+
+    stdexec::sync_wait(scope.on_empty() | stdexec::transfer(uvLoop.get_scheduler()));
+    REQUIRE(executed == 2 * highWaterMark);
+}
+
+TEST_CASE("Loop allocator", "[loop][mt]") {
+    constexpr int iterations = 1000;
+
+    TLoop uvLoop;
+    TLoopAllocator<std::uint64_t> allocator(uvLoop);
+
+    auto offLoop = allocator.allocate(4);
+    offLoop[3] = 42;
+    allocator.deallocate(offLoop, 4);
+
+    auto [first, again] = stdexec::sync_wait(stdexec::schedule(uvLoop.get_scheduler()) | stdexec::then([&] {
+        auto first = allocator.allocate(4);
+        allocator.deallocate(first, 4);
+        return std::make_pair(first, allocator.allocate(4));
+    })).value();
+    REQUIRE(first == again);
+
+    std::thread([&] {
+        allocator.deallocate(again, 4); // Handed back to the loop
+    }).join();
+    auto [reclaimed] = stdexec::sync_wait(stdexec::schedule(uvLoop.get_scheduler()) | stdexec::then([&] {
+        return allocator.allocate(4);
+    })).value();
+    REQUIRE(reclaimed == again);
+    REQUIRE(uvLoop.GetAllocator().GetLiveBlocks() == 1);
+    allocator.deallocate(reclaimed, 4);
+    REQUIRE(uvLoop.GetAllocator().GetLiveBlocks() == 0);
+
+    int counter{0};
+    std::size_t spawnedBlocks{0};
+    exec::async_scope scope;
+    stdexec::sync_wait(stdexec::schedule(uvLoop.get_scheduler()) | stdexec::let_value([&]() noexcept {
+        for (int i = 0; i < iterations; ++i) {
+            uvexec::spawn(scope, stdexec::schedule(uvLoop.get_scheduler()) | stdexec::then([&]() noexcept {
+                ++counter;
+            }), TLoop::TScheduler::TLoopEnv(uvLoop));
+        }
+        spawnedBlocks = uvLoop.GetAllocator().GetLiveBlocks();
+        return scope.on_empty();
+    }));
+    REQUIRE(counter == iterations);
+    REQUIRE(spawnedBlocks >= iterations);
+    REQUIRE(uvLoop.GetAllocator().GetLiveBlocks() == 0);
+}
+
+TEST_CASE("Loop metrics", "[loop]") {
+    constexpr int iterations = 100;
+
+    REQUIRE(TLoop().GetMetrics() == nullptr);
+
+    TLoop uvLoop(TLoopOptions{.CollectMetrics = true});
+    exec::async_scope scope;
+    for (int i = 0; i < iterations; ++i) {
+        scope.spawn(stdexec::schedule(uvLoop.get_scheduler()));
+    }
+    stdexec::sync_wait(
+            stdexec::schedule(uvLoop.get_scheduler())
+            | stdexec::let_value([&]() noexcept {
+                return scope.on_empty();
+            }));
+
+    auto& metrics = *uvLoop.GetMetrics();
+    REQUIRE(metrics.Scheduled.load() >= iterations);
+    REQUIRE(metrics.Applied.load() >= iterations);
+    REQUIRE(metrics.QueueDepth() == 0);
+    REQUIRE(metrics.BatchSizes.Count() > 0);
+    REQUIRE(metrics.BatchSizes.Sum() == metrics.Applied.load());
+    REQUIRE(metrics.Iterations.load() > 0);
+}
+
+TEST_CASE("Trace buffer", "[loop][trace]") {
+    TTraceBuffer trace(3); // Rounded up to 4
+    for (std::uint64_t i = 0; i < 6; ++i) {
+        trace.Record(TTraceEvent{"op", i * 1000, i * 1000 + 1500, 0});
+    }
+
+    auto events = trace.Snapshot();
+    REQUIRE(events.size() == 4);
+    REQUIRE(events.front().BeginNs == 2000);
+    REQUIRE(events.back().BeginNs == 5000);
+
+    std::ostringstream out;
+    const TTraceBuffer* traces[] = {&trace, nullptr};
+    WriteChromeTrace(out, traces);
+    auto json = out.str();
+    REQUIRE(json.starts_with(R"({"displayTimeUnit":"ns","traceEvents":[{"cat":"uvexec","name":"op","ph":"b","id":0,)"));
+    REQUIRE(json.find(R"("ph":"e","id":3,)") != std::string::npos);
+    REQUIRE(json.find(R"("ts":6.500})") != std::string::npos);
+    REQUIRE(json.ends_with("}]}"));
+
+    TTraceBuffer escaped(1);
+    escaped.Record(TTraceEvent{"say \"hi\"\\\n", 0, 1, 0});
+    const TTraceBuffer* escapedTraces[] = {&escaped};
+    std::ostringstream escapedOut;
+    WriteChromeTrace(escapedOut, escapedTraces);
+    REQUIRE(escapedOut.str().find(R"("name":"say \"hi\"\\\u000a",)") != std::string::npos);
+}
+
 TEST_CASE("Parallel sync_wait", "[loop][mt]") {
     constexpr int iterations = 1000;
 
@@ -287,6 +745,18 @@ TEST_CASE("High parallel sync_wait", "[loop][mt]") {
     REQUIRE(counter == threadsCount * iterations);
 }
 
+TEST_CASE("Runner promoted after finishing", "[loop]") {
+    TRunner runner;
+    runner.Finish();
+    // The leader may promote a runner that finished after it was checked, the promotion must not revive it
+    runner.Promote();
+    REQUIRE(runner.Finished());
+    runner.Wait();
+    REQUIRE(runner.TakePromotion());
+    REQUIRE_FALSE(runner.AcquireIfNotFinished());
+    REQUIRE_FALSE(runner.Acquired());
+}
+
 TEST_CASE("Concurrent run and sync_wait", "[loop][mt]") {
     constexpr int iterations = 1000;
 
@@ -314,6 +784,40 @@ TEST_CASE("Concurrent run and sync_wait", "[loop][mt]") {
     REQUIRE(counter == iterations);
 }
 
+TEST_CASE("Loop watchdog", "[loop][mt]") {
+    TLoop uvLoop;
+    std::thread runner([&]() {
+        uvLoop.run();
+    });
+
+    {
+        std::atomic_int stalls{0};
+        TLoopWatchdog watchdog(uvLoop, TLoopWatchdogOptions{
+            .ProbePeriod = 1ms,
+            .StallThreshold = 50ms,
+            .OnStall = [&](TLoop& loop, std::chrono::nanoseconds stuck) {
+                if (&loop == &uvLoop && stuck >= 50ms) {
+                    stalls.fetch_add(1);
+                }
+            }});
+
+        stdexec::sync_wait(stdexec::schedule(uvLoop.get_scheduler()) | stdexec::then([]() noexcept {
+            std::this_thread::sleep_for(200ms); // Blocking the loop
+        }));
+        std::this_thread::sleep_for(20ms);
+
+        REQUIRE(stalls.load() >= 1);
+        REQUIRE(watchdog.GetStallsCount() == static_cast<std::uint64_t>(stalls.load()));
+        REQUIRE(watchdog.GetLags().Count() > 0);
+        REQUIRE(watchdog.GetLags().Quantile(1.0) >= static_cast<std::uint64_t>(std::chrono::nanoseconds(50ms).count()));
+    }
+
+    stdexec::sync_wait(stdexec::schedule(uvLoop.get_scheduler()) | stdexec::then([&]() noexcept {
+        uvLoop.finish();
+    }));
+    runner.join();
+}
+
 TEST_CASE("Coroutines", "[loop][coro]") {
     TLoop uvLoop;
 
@@ -358,3 +862,78 @@ TEST_CASE("Coroutines", "[loop][coro]") {
     NUvUtil::Close(idler);
     uvLoop.run_once(); // Error idle closing
 }
+
+TEST_CASE("Loop task", "[loop][coro]") {
+    TLoop uvLoop;
+
+    std::size_t cnt{0};
+    uv_idle_t idler;
+    ::uv_idle_init(&NUvUtil::RawUvObject(uvLoop), &idler);
+    idler.data = &cnt;
+    ::uv_idle_start(&idler, [](uv_idle_t* handle){
+        auto& cnt = *static_cast<std::size_t*>(handle->data);
+        ++cnt;
+    });
+
+    auto task = [](int n) -> TTask<int> {
+        for (int i = 0; i < n; ++i) {
+            auto _ = co_await stdexec::get_scheduler();
+        }
+        co_return n;
+    };
+    int n = GENERATE(6, 13, 57);
+
+    SECTION("Awaited senders completing on the loop don't reschedule") {
+        auto [result] = stdexec::sync_wait(stdexec::schedule(uvLoop.get_scheduler()) | stdexec::let_value([&]() {
+            return task(n);
+        })).value();
+        REQUIRE(result == n);
+        REQUIRE(cnt == 1);
+    }
+
+    SECTION("Nested tasks") {
+        std::vector<std::size_t> resumedAt;
+        auto outerTask = [&task, &resumedAt, &cnt](int n) -> TTask<int> {
+            int sum = 0;
+            for (int i = 0; i < n; ++i) {
+                sum += co_await task(i);
+                co_await stdexec::schedule(co_await stdexec::get_scheduler());
+                resumedAt.push_back(cnt);
+            }
+            co_return sum;
+        };
+
+        auto [sum] = stdexec::sync_wait(stdexec::schedule(uvLoop.get_scheduler()) | stdexec::let_value([&]() {
+            return outerTask(n);
+        })).value();
+        REQUIRE(sum == n * (n - 1) / 2);
+        // Nested tasks resume inline, while every explicit schedule from the loop thread is applied by the next
+        // iteration, never in the same pass as the operation that scheduled it
+        REQUIRE(resumedAt.size() == static_cast<std::size_t>(n));
+        REQUIRE(resumedAt.front() > 1);
+        for (std::size_t i = 1; i < resumedAt.size(); ++i) {
+            REQUIRE(resumedAt[i] == resumedAt[i - 1] + 1);
+        }
+    }
+
+    SECTION("Exceptions and stop propagation") {
+        auto failingTask = [&task]() -> TTask<> {
+            co_await task(1);
+            throw std::runtime_error("Task failed");
+        };
+        auto stoppedTask = [&task]() -> TTask<> {
+            co_await task(1);
+            co_await stdexec::just_stopped();
+            FAIL("Resumed after set_stopped");
+        };
+
+        REQUIRE_THROWS_AS(stdexec::sync_wait(stdexec::schedule(uvLoop.get_scheduler()) | stdexec::let_value([&]() {
+            return failingTask();
+        })), std::runtime_error);
+        REQUIRE_FALSE(stdexec::sync_wait(stdexec::schedule(uvLoop.get_scheduler()) | stdexec::let_value([&]() {
+            return stoppedTask();
+        })).has_value());
+    }
+    NUvUtil::Close(idler);
+    uvLoop.run_once(); // Error idle closing
+}
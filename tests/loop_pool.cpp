@@ -0,0 +1,454 @@
+/*
+ * Copyright (c) 2024 Michael Guzov
+ *
+ * Licensed under the Apache License Version 2.0 with LLVM Exceptions
+ * (the "License"); you may not use this file except in compliance with
+ * the License. You may obtain a copy of the License at
+ *
+ *   https://llvm.org/LICENSE.txt
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+
+#include <uvexec/execution/loop_pool.hpp>
+#include <uvexec/execution/steal_deque.hpp>
+#include <uvexec/algorithms/schedule.hpp>
+#include <uvexec/algorithms/bulk.hpp>
+
+#include <exec/async_scope.hpp>
+
+#include <latch>
+#include <memory>
+#include <mutex>
+#include <set>
+
+#include <sched.h>
+
+
+using namespace NUvExec;
+using namespace std::literals;
+
+TEST_CASE("Trivial pool", "[pool]") {
+    TLoopPool pool(2);
+    REQUIRE(pool.size() == 2);
+
+    auto threadId = std::this_thread::get_id();
+
+    auto [innerThreadId] = stdexec::sync_wait(
+            stdexec::schedule(pool.get_scheduler()) | stdexec::then([] {
+                return std::this_thread::get_id();
+            })).value();
+
+    REQUIRE(threadId != innerThreadId);
+}
+
+TEST_CASE("Pool loop scheduler", "[pool]") {
+    TLoopPool pool(2);
+
+    auto [first] = stdexec::sync_wait(
+            stdexec::schedule(pool.get_scheduler(0)) | stdexec::then([] {
+                return std::this_thread::get_id();
+            })).value();
+    auto [second] = stdexec::sync_wait(
+            stdexec::schedule(pool.get_scheduler(1)) | stdexec::then([] {
+                return std::this_thread::get_id();
+            })).value();
+    auto [again] = stdexec::sync_wait(
+            stdexec::schedule(pool.get_scheduler(0)) | stdexec::then([] {
+                return std::this_thread::get_id();
+            })).value();
+
+    REQUIRE(first != std::this_thread::get_id());
+    REQUIRE(second != std::this_thread::get_id());
+    REQUIRE(first != second);
+    REQUIRE(first == again);
+}
+
+TEST_CASE("Pinned pool", "[pool][mt]") {
+    // Pin to a CPU the test process may actually run on: cpusets and containers can exclude CPU 0.
+    ::cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    REQUIRE(::sched_getaffinity(0, sizeof(allowed), &allowed) == 0);
+    int pinned = 0;
+    while (pinned < CPU_SETSIZE && !CPU_ISSET(pinned, &allowed)) {
+        ++pinned;
+    }
+    REQUIRE(pinned < CPU_SETSIZE);
+
+    TLoopPool pool(TLoopPoolOptions{.Size = 2, .Affinity = {{static_cast<std::size_t>(pinned)}}});
+
+    auto cpus = std::vector<int>{};
+    for (std::size_t i = 0; i < pool.size(); ++i) {
+        auto [cpu] = stdexec::sync_wait(stdexec::schedule(pool.get_scheduler(i)) | stdexec::then([] {
+            return ::uv_thread_getcpu();
+        })).value();
+        cpus.push_back(cpu);
+    }
+
+    REQUIRE(cpus == std::vector{pinned, pinned});
+    REQUIRE_THROWS_AS(TLoopPool(TLoopPoolOptions{.Size = 1, .Affinity = {{1 << 20}}}), std::system_error);
+}
+
+TEST_CASE("Pool spreads work", "[pool][mt]") {
+    constexpr int iterations = 1000;
+
+    TLoopPool pool(4);
+    auto balancing = GENERATE(EBalancing::RoundRobin, EBalancing::LeastLoaded);
+
+    std::mutex mtx;
+    std::set<std::thread::id> threads;
+    std::atomic_int counter{0};
+
+    exec::async_scope scope;
+    for (int i = 0; i < iterations; ++i) {
+        scope.spawn(stdexec::schedule(pool.get_scheduler(balancing)) | stdexec::then([&]() noexcept {
+            std::lock_guard lock(mtx);
+            threads.insert(std::this_thread::get_id());
+            counter.fetch_add(1, std::memory_order_relaxed);
+        }));
+    }
+    stdexec::sync_wait(scope.on_empty());
+
+    REQUIRE(counter.load() == iterations);
+    REQUIRE_FALSE(threads.contains(std::this_thread::get_id()));
+    if (balancing == EBalancing::RoundRobin) {
+        REQUIRE(threads.size() == pool.size());
+    }
+}
+
+TEST_CASE("Least loaded pool avoids a busy worker", "[pool][mt]") {
+    constexpr int iterations = 100;
+
+    TLoopPool pool(2);
+    auto threadOf = [&](std::size_t idx) {
+        auto [id] = stdexec::sync_wait(stdexec::schedule(pool.get_scheduler(idx)) | stdexec::then([] {
+            return std::this_thread::get_id();
+        })).value();
+        return id;
+    };
+    auto first = threadOf(0);
+    auto second = threadOf(1);
+
+    std::latch blocked{1};
+    std::latch release{1};
+    std::atomic<std::thread::id> queued;
+    exec::async_scope scope;
+    // Occupy the first worker's thread, then queue one balanced operation behind it: with equal loads the
+    // first worker is picked, and its load stays at 1 until the thread is released
+    scope.spawn(stdexec::schedule(pool.get_scheduler(0)) | stdexec::then([&]() noexcept {
+        blocked.count_down();
+        release.wait();
+    }));
+    blocked.wait();
+    scope.spawn(stdexec::schedule(pool.get_scheduler(EBalancing::LeastLoaded)) | stdexec::then([&]() noexcept {
+        queued = std::this_thread::get_id();
+    }));
+
+    // Every later submission completes before the next one starts, so the second worker is always idle
+    int onSecond = 0;
+    for (int i = 0; i < iterations; ++i) {
+        auto [id] = stdexec::sync_wait(stdexec::schedule(pool.get_scheduler(EBalancing::LeastLoaded))
+                | stdexec::then([] {
+                    return std::this_thread::get_id();
+                })).value();
+        onSecond += id == second;
+    }
+    REQUIRE(onSecond == iterations);
+
+    release.count_down();
+    stdexec::sync_wait(scope.on_empty());
+    REQUIRE(queued.load() == first);
+}
+
+TEST_CASE("Work stealing", "[pool][mt]") {
+    constexpr int iterations = 64;
+
+    TLoopPool pool(2);
+
+    std::mutex mtx;
+    std::set<std::thread::id> threads;
+
+    exec::async_scope scope;
+    stdexec::sync_wait(stdexec::schedule(pool.get_scheduler(0)) | stdexec::then([&]() noexcept {
+        // All operations are pushed to the current loop, so the other one may only steal them
+        for (int i = 0; i < iterations; ++i) {
+            scope.spawn(stdexec::schedule(pool.get_scheduler(EBalancing::WorkStealing))
+                    | stdexec::then([&]() noexcept {
+                        std::this_thread::sleep_for(1ms);
+                        std::lock_guard lock(mtx);
+                        threads.insert(std::this_thread::get_id());
+                    }));
+        }
+    }));
+    stdexec::sync_wait(scope.on_empty());
+
+    REQUIRE(threads.size() == pool.size());
+}
+
+TEST_CASE("Work stealing from a blocked worker", "[pool][mt]") {
+    constexpr int iterations = 64;
+
+    TLoopPool pool(2);
+    auto [blockedThread] = stdexec::sync_wait(stdexec::schedule(pool.get_scheduler(0)) | stdexec::then([] {
+        return std::this_thread::get_id();
+    })).value();
+
+    std::latch blocked{1};
+    std::latch release{1};
+    std::latch done{iterations};
+    std::atomic_int onBlocked{0};
+
+    exec::async_scope scope;
+    scope.spawn(stdexec::schedule(pool.get_scheduler(0)) | stdexec::then([&]() noexcept {
+        blocked.count_down();
+        release.wait();
+    }));
+    blocked.wait();
+    // Submitted from outside the pool, so half of them land in the inbox of the blocked worker
+    for (int i = 0; i < iterations; ++i) {
+        scope.spawn(stdexec::schedule(pool.get_scheduler(EBalancing::WorkStealing)) | stdexec::then([&]() noexcept {
+            if (std::this_thread::get_id() == blockedThread) {
+                onBlocked.fetch_add(1);
+            }
+            done.count_down();
+        }));
+    }
+    done.wait();
+    REQUIRE(onBlocked.load() == 0);
+
+    release.count_down();
+    stdexec::sync_wait(scope.on_empty());
+}
+
+TEST_CASE("Stopped pool completes stealable work", "[pool][mt]") {
+    constexpr int iterations = 256; // More than one drain applies
+
+    auto pool = std::make_unique<TLoopPool>(1);
+    std::latch blocked{1};
+    std::latch release{1};
+    std::atomic_int executed{0};
+    std::atomic_int stopped{0};
+
+    exec::async_scope scope;
+    scope.spawn(stdexec::schedule(pool->get_scheduler(0)) | stdexec::then([&]() noexcept {
+        blocked.count_down();
+        release.wait();
+    }));
+    blocked.wait();
+    for (int i = 0; i < iterations; ++i) {
+        scope.spawn(stdexec::schedule(pool->get_scheduler(EBalancing::WorkStealing))
+                | stdexec::then([&]() noexcept {
+                    executed.fetch_add(1);
+                })
+                | stdexec::upon_stopped([&]() noexcept {
+                    stopped.fetch_add(1);
+                }));
+    }
+    // The pool is likely to finish its loop in between two drains, the rest is left in the inbox
+    std::thread stopper([&] {
+        pool.reset();
+    });
+    std::this_thread::sleep_for(10ms);
+    release.count_down();
+    stopper.join();
+
+    stdexec::sync_wait(scope.on_empty());
+    REQUIRE(executed.load() + stopped.load() == iterations);
+}
+
+TEST_CASE("Steal deque", "[pool]") {
+    struct TNop final : TLoop::TOperation {
+        void Apply() noexcept override {}
+    };
+
+    std::vector<TNop> ops(TStealDeque::Capacity + 1);
+    TStealDeque deque;
+    for (std::size_t i = 0; i < TStealDeque::Capacity; ++i) {
+        REQUIRE(deque.Push(ops[i]));
+    }
+    REQUIRE_FALSE(deque.Push(ops.back()));
+    REQUIRE(deque.Size() == TStealDeque::Capacity);
+
+    // The owner takes the newest operations, thieves the oldest ones
+    REQUIRE(deque.Pop() == &ops[TStealDeque::Capacity - 1]);
+    REQUIRE(deque.Steal() == &ops[0]);
+    while (deque.Pop() != nullptr) {}
+    REQUIRE(deque.Empty());
+    REQUIRE(deque.Steal() == nullptr);
+}
+
+TEST_CASE("Concurrent steal deque", "[pool][mt]") {
+    struct TCounted final : TLoop::TOperation {
+        void Apply() noexcept override {
+            Applied.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        std::atomic_int Applied{0};
+    };
+
+    constexpr std::size_t iterations = 100'000;
+    constexpr int thievesCount = 3;
+
+    std::vector<TCounted> ops(iterations);
+    TStealDeque deque;
+    std::atomic_bool done{false};
+    std::vector<std::thread> thieves;
+    for (int i = 0; i < thievesCount; ++i) {
+        thieves.emplace_back([&] {
+            while (!done.load()) {
+                if (auto op = deque.Steal()) {
+                    op->Apply();
+                }
+            }
+        });
+    }
+    for (std::size_t i = 0; i < iterations; ++i) {
+        while (!deque.Push(ops[i])) {
+            if (auto op = deque.Pop()) {
+                op->Apply();
+            }
+        }
+        if (i % 3 == 0) {
+            if (auto op = deque.Pop()) {
+                op->Apply();
+            }
+        }
+    }
+    while (auto op = deque.Pop()) {
+        op->Apply();
+    }
+    done.store(true);
+    for (auto& thief : thieves) {
+        thief.join();
+    }
+
+    REQUIRE(std::all_of(ops.begin(), ops.end(), [](const TCounted& op) noexcept {
+        return op.Applied.load() == 1;
+    }));
+}
+
+TEST_CASE("Steal ring", "[pool]") {
+    struct TNop final : TLoop::TOperation {
+        void Apply() noexcept override {}
+    };
+
+    std::vector<TNop> ops(TStealRing::Capacity + 1);
+    TStealRing ring;
+    REQUIRE(ring.Empty());
+    for (std::size_t i = 0; i < TStealRing::Capacity; ++i) {
+        REQUIRE(ring.Push(ops[i]));
+    }
+    REQUIRE_FALSE(ring.Push(ops.back()));
+
+    // First in, first out, and a freed slot is reused by the next lap
+    REQUIRE(ring.Steal() == &ops[0]);
+    REQUIRE(ring.Push(ops.back()));
+    for (std::size_t i = 1; i < TStealRing::Capacity; ++i) {
+        REQUIRE(ring.Steal() == &ops[i]);
+    }
+    REQUIRE(ring.Steal() == &ops.back());
+    REQUIRE(ring.Empty());
+    REQUIRE(ring.Steal() == nullptr);
+}
+
+TEST_CASE("Concurrent steal ring", "[pool][mt]") {
+    struct TCounted final : TLoop::TOperation {
+        void Apply() noexcept override {
+            Applied.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        std::atomic_int Applied{0};
+    };
+
+    constexpr std::size_t iterations = 100'000;
+    constexpr std::size_t producersCount = 3;
+    constexpr int thievesCount = 3;
+
+    std::vector<TCounted> ops(iterations * producersCount);
+    TStealRing ring;
+    std::atomic_bool done{false};
+    std::vector<std::thread> thieves;
+    for (int i = 0; i < thievesCount; ++i) {
+        thieves.emplace_back([&] {
+            while (!done.load()) {
+                if (auto op = ring.Steal()) {
+                    op->Apply();
+                }
+            }
+        });
+    }
+    std::vector<std::thread> producers;
+    for (std::size_t p = 0; p < producersCount; ++p) {
+        producers.emplace_back([&, p] {
+            for (std::size_t i = p * iterations; i < (p + 1) * iterations; ++i) {
+                while (!ring.Push(ops[i])) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    while (!ring.Empty()) {
+        std::this_thread::yield();
+    }
+    done.store(true);
+    for (auto& thief : thieves) {
+        thief.join();
+    }
+
+    REQUIRE(std::all_of(ops.begin(), ops.end(), [](const TCounted& op) noexcept {
+        return op.Applied.load() == 1;
+    }));
+}
+
+TEST_CASE("Bulk on pool", "[pool][mt]") {
+    constexpr int iterations = 1000;
+
+    TLoopPool pool(4);
+    TLoop loop(TLoopOptions{.BulkPool = &pool});
+
+    std::mutex mtx;
+    std::set<std::thread::id> threads;
+    std::vector<int> executed(iterations, 0);
+
+    auto [sum, threadId] = stdexec::sync_wait(stdexec::schedule(loop.get_scheduler())
+            | stdexec::then([] {
+                return 42;
+            })
+            | stdexec::bulk(iterations, [&](int i, int value) {
+                executed[i] += value;
+                std::lock_guard lock(mtx);
+                threads.insert(std::this_thread::get_id());
+            })
+            | stdexec::then([](int value) {
+                return std::make_pair(value, std::this_thread::get_id());
+            })).value();
+
+    REQUIRE(sum == 42);
+    REQUIRE(threadId == std::this_thread::get_id());
+    REQUIRE(std::all_of(executed.begin(), executed.end(), [](int i) noexcept { return i == 42; }));
+    REQUIRE(threads.size() == pool.size());
+    REQUIRE_FALSE(threads.contains(std::this_thread::get_id()));
+}
+
+TEST_CASE("Bulk on pool throws", "[pool][mt]") {
+    TLoopPool pool(2);
+    TLoop loop(TLoopOptions{.BulkPool = &pool});
+
+    auto job = stdexec::schedule(loop.get_scheduler())
+            | stdexec::bulk(100, [](int i) {
+                if (i == 77) {
+                    throw std::runtime_error("Bulk failed");
+                }
+            });
+
+    REQUIRE_THROWS_AS(stdexec::sync_wait(std::move(job)), std::runtime_error);
+}
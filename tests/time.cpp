@@ -18,21 +18,173 @@
 
 #include <uvexec/execution/loop.hpp>
 #include <uvexec/algorithms/after.hpp>
+#include <uvexec/algorithms/every.hpp>
 #include <uvexec/algorithms/schedule.hpp>
+#include <uvexec/algorithms/with_timeout.hpp>
 
 #include <exec/task.hpp>
 #include <exec/async_scope.hpp>
 #include <exec/when_any.hpp>
 #include <exec/repeat_n.hpp>
 
+#include <atomic>
 #include <latch>
+#include <optional>
+#include <thread>
+#include <vector>
 
 
 using namespace NUvExec;
 using namespace std::literals;
 
+namespace {
+
+// Never completes with a value, stops right from within the stop callback
+class TStoppedOnRequestSender {
+    template <typename TReceiver>
+    class TOpState {
+        struct TOnStop {
+            void operator()() const noexcept {
+                stdexec::set_stopped(std::move(Op->Receiver));
+            }
+
+            TOpState* Op;
+        };
+
+        using TStopCallback = typename stdexec::stop_token_of_t<
+                stdexec::env_of_t<TReceiver>>::template callback_type<TOnStop>;
+
+    public:
+        explicit TOpState(TReceiver receiver) noexcept: Receiver(std::move(receiver)) {}
+
+        friend void tag_invoke(stdexec::start_t, TOpState& op) noexcept {
+            op.StopCallback.emplace(stdexec::get_stop_token(stdexec::get_env(op.Receiver)), TOnStop{&op});
+        }
+
+    private:
+        TReceiver Receiver;
+        std::optional<TStopCallback> StopCallback;
+    };
+
+public:
+    using sender_concept = stdexec::sender_t;
+    using completion_signatures = stdexec::completion_signatures<stdexec::set_value_t(), stdexec::set_stopped_t()>;
+
+    explicit TStoppedOnRequestSender(TLoop& loop) noexcept: Loop{&loop} {}
+
+    template <stdexec::receiver TReceiver>
+    friend auto tag_invoke(stdexec::connect_t, TStoppedOnRequestSender, TReceiver&& rec) {
+        return TOpState<std::decay_t<TReceiver>>(std::forward<TReceiver>(rec));
+    }
+
+    friend auto tag_invoke(stdexec::get_env_t, const TStoppedOnRequestSender& s) noexcept {
+        return TLoop::TScheduler::TEnv(*s.Loop);
+    }
+
+private:
+    TLoop* Loop;
+};
+
+// Never completes with a value, stops when the test calls Stop, on the thread that calls it
+class TManualStopSender {
+public:
+    struct TStopper {
+        virtual void Stop() noexcept = 0;
+    };
+
+private:
+    template <typename TReceiver>
+    class TOpState final : public TStopper {
+    public:
+        TOpState(TReceiver receiver, std::atomic<TStopper*>& started) noexcept
+            : Receiver(std::move(receiver)), Started{&started}
+        {}
+
+        friend void tag_invoke(stdexec::start_t, TOpState& op) noexcept {
+            op.Started->store(&op);
+        }
+
+        void Stop() noexcept override {
+            stdexec::set_stopped(std::move(Receiver));
+        }
+
+    private:
+        TReceiver Receiver;
+        std::atomic<TStopper*>* Started;
+    };
+
+public:
+    using sender_concept = stdexec::sender_t;
+    using completion_signatures = stdexec::completion_signatures<stdexec::set_value_t(), stdexec::set_stopped_t()>;
+
+    explicit TManualStopSender(std::atomic<TStopper*>& started) noexcept: Started{&started} {}
+
+    template <stdexec::receiver TReceiver>
+    friend auto tag_invoke(stdexec::connect_t, TManualStopSender s, TReceiver&& rec) {
+        return TOpState<std::decay_t<TReceiver>>(std::forward<TReceiver>(rec), *s.Started);
+    }
+
+    friend auto tag_invoke(stdexec::get_env_t, const TManualStopSender&) noexcept {
+        return stdexec::empty_env{};
+    }
+
+private:
+    std::atomic<TStopper*>* Started;
+};
+
+}
+
 TEST_CASE("Clock", "[loop][timer]") {
-    STATIC_REQUIRE(std::same_as<TLoopClock::duration, std::chrono::milliseconds>);
+    STATIC_REQUIRE(std::same_as<TLoopClock::duration, std::chrono::nanoseconds>);
+
+    TLoop loop;
+    auto before = TLoopClock::now();
+    auto now = exec::now(loop.get_scheduler());
+    REQUIRE(before <= now);
+    REQUIRE(now <= TLoopClock::now());
+}
+
+TEST_CASE("Timer wheel", "[timer]") {
+    struct TTestTimer : TTimerWheel::TTimer {
+        void Fire() noexcept override {}
+    };
+
+    TTimerWheel wheel(1000);
+    std::vector<TTestTimer> timers(5);
+    std::uint64_t deadlines[] = {1000, 1001, 1063, 1000 + (1 << 20), 1000 + (std::uint64_t{1} << 40)};
+    for (std::size_t i = 0; i < timers.size(); ++i) {
+        timers[i].Deadline = deadlines[i];
+        wheel.Insert(timers[i]);
+    }
+    REQUIRE(wheel.Size() == 5);
+    REQUIRE(wheel.NextExpiry() == 1000);
+
+    auto advance = [&](std::uint64_t now) {
+        std::vector<std::uint64_t> expired;
+        wheel.Advance(now);
+        while (auto timer = wheel.PopExpired()) {
+            expired.push_back(timer->Deadline);
+        }
+        return expired;
+    };
+
+    REQUIRE(advance(1000) == std::vector<std::uint64_t>{1000});
+    REQUIRE(wheel.NextExpiry() == 1001);
+    REQUIRE(wheel.Cancel(timers[2]));
+    REQUIRE_FALSE(wheel.Cancel(timers[2]));
+    REQUIRE(advance(2000) == std::vector<std::uint64_t>{1001});
+
+    // Far timers cascade down through the levels and fire exactly once
+    std::uint64_t now = 2000;
+    std::vector<std::uint64_t> fired;
+    while (!wheel.Empty() && fired.size() < 2) {
+        now = std::max(now, wheel.NextExpiry());
+        REQUIRE(now <= deadlines[3 + fired.size()]);
+        auto expired = advance(now);
+        fired.insert(fired.end(), expired.begin(), expired.end());
+    }
+    REQUIRE(fired == std::vector<std::uint64_t>{deadlines[3], deadlines[4]});
+    REQUIRE(wheel.NextExpiry() == TTimerWheel::Never);
 }
 
 TEST_CASE("Trivial after", "[loop][timer]") {
@@ -126,6 +278,44 @@ TEST_CASE("After negative", "[loop][timer]") {
     CHECK(start + 5ms > std::chrono::steady_clock::now());
 }
 
+TEST_CASE("Sub-millisecond after", "[loop][timer]") {
+    constexpr auto timeout = 200us;
+    constexpr int n = 10;
+
+    TLoop loop(TLoopOptions{.CollectMetrics = true});
+
+    int early{0};
+    auto start = std::chrono::steady_clock::now();
+    stdexec::sync_wait(stdexec::schedule(loop.get_scheduler()) | stdexec::let_value([&]() noexcept {
+        auto deadline = exec::now(loop.get_scheduler()) + timeout;
+        return exec::schedule_after(loop.get_scheduler(), timeout) | stdexec::then([&, deadline]() noexcept {
+            early += exec::now(loop.get_scheduler()) < deadline;
+        });
+    }) | exec::repeat_n(n));
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    REQUIRE(early == 0);
+    REQUIRE(elapsed >= n * timeout);
+    REQUIRE(loop.GetMetrics()->TimerTicks.load() >= n); // Every timer went through the wheel
+}
+
+// Wall-clock latency depends on the machine, so it's only run on demand
+TEST_CASE("Sub-millisecond after latency", "[.][loop][timer]") {
+    constexpr auto timeout = 200us;
+    constexpr int n = 10;
+
+    TLoop loop;
+
+    auto start = std::chrono::steady_clock::now();
+    stdexec::sync_wait(exec::schedule_after(loop.get_scheduler(), timeout) | exec::repeat_n(n));
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+#ifdef __linux__
+    // Rounded up to milliseconds, the timers would take at least n ms
+    CHECK(elapsed < n * 1ms);
+#endif
+}
+
 TEST_CASE("Trivial at", "[loop][timer]") {
     constexpr auto timeout = 50ms;
 
@@ -361,6 +551,18 @@ TEST_CASE("After facade follows at", "[loop][timer]") {
     REQUIRE(start + 2 * timeout <= std::chrono::steady_clock::now() + 1ms);
 }
 
+#ifdef UVEXEC_ENABLE_TRACING
+TEST_CASE("Traced after", "[loop][timer][trace]") {
+    TLoop loop;
+    stdexec::sync_wait(exec::schedule_after(loop.get_scheduler(), 10ms));
+
+    auto events = loop.GetTrace()->Snapshot();
+    REQUIRE(events.size() == 1);
+    REQUIRE(std::string_view(events[0].Name) == "after");
+    REQUIRE(events[0].EndNs - events[0].BeginNs >= std::chrono::nanoseconds(5ms).count());
+}
+#endif
+
 TEST_CASE("When any", "[loop][timer]") {
     constexpr auto timeout = 50ms;
 
@@ -444,3 +646,176 @@ TEST_CASE("Racy timer cancellation", "[loop][timer][mt]") {
     t.join();
     CHECK(executed < 10'000);
 }
+
+TEST_CASE("Many timers", "[loop][timer]") {
+    constexpr int timersCount = 10'000;
+
+    TLoop loop;
+
+    int early{0};
+    int executed{0};
+    exec::async_scope scope;
+    stdexec::sync_wait(stdexec::schedule(loop.get_scheduler()) | stdexec::let_value([&]() noexcept {
+        for (int i = 0; i < timersCount; ++i) {
+            auto timeout = std::chrono::milliseconds(i % 64);
+            auto deadline = exec::now(loop.get_scheduler()) + timeout;
+            scope.spawn(exec::schedule_after(loop.get_scheduler(), timeout) | stdexec::then([&, deadline]() noexcept {
+                early += exec::now(loop.get_scheduler()) < deadline;
+                ++executed;
+            }));
+        }
+        // Cancelled timers leave the wheel without firing
+        scope.spawn(exec::when_any(exec::schedule_after(loop.get_scheduler(), 1h), stdexec::just()));
+        return scope.on_empty();
+    })).value();
+
+    REQUIRE(executed == timersCount);
+    REQUIRE(early == 0);
+}
+
+TEST_CASE("Timer slack", "[loop][timer]") {
+    constexpr int timersCount = 16;
+    constexpr auto slack = 16ms;
+
+    TLoop loop(TLoopOptions{.CollectMetrics = true});
+
+    int early{0};
+    int executed{0};
+    exec::async_scope scope;
+    stdexec::sync_wait(stdexec::schedule(loop.get_scheduler()) | stdexec::let_value([&]() noexcept {
+        for (int i = 1; i <= timersCount; ++i) {
+            auto timeout = std::chrono::milliseconds(i);
+            auto deadline = exec::now(loop.get_scheduler()) + timeout;
+            scope.spawn(uvexec::after(stdexec::schedule(loop.get_scheduler()), timeout, slack)
+                    | stdexec::then([&, deadline]() noexcept {
+                        early += exec::now(loop.get_scheduler()) < deadline;
+                        ++executed;
+                    }));
+        }
+        return scope.on_empty();
+    })).value();
+
+    REQUIRE(executed == timersCount);
+    REQUIRE(early == 0);
+    // Deadlines are rounded to a few multiples of the largest power of two microseconds within the slack
+    REQUIRE(loop.GetMetrics()->TimerTicks.load() <= 4);
+}
+
+TEST_CASE("Every", "[loop][timer]") {
+    constexpr auto period = 5ms;
+    constexpr std::size_t ticksCount = 10;
+
+    TLoop loop;
+
+    std::size_t ticks{0};
+    std::vector<TLoopClock::time_point> times;
+    auto start = exec::now(loop.get_scheduler());
+    stdexec::sync_wait(stdexec::schedule(loop.get_scheduler()) | stdexec::let_value([&]() noexcept {
+        return uvexec::every(period, [&](std::size_t elapsed) noexcept {
+            ticks += elapsed;
+            times.push_back(exec::now(loop.get_scheduler()));
+            return ticks < ticksCount;
+        });
+    }));
+
+    REQUIRE(ticks >= ticksCount);
+    REQUIRE(start + ticks * period <= exec::now(loop.get_scheduler()));
+    for (std::size_t i = 1; i < times.size(); ++i) {
+        REQUIRE(times[i - 1] < times[i]);
+    }
+}
+
+TEST_CASE("Every until stopped", "[loop][timer]") {
+    TLoop loop;
+
+    int ticks{0};
+    auto [stopped] = stdexec::sync_wait(stdexec::schedule(loop.get_scheduler()) | stdexec::let_value([&]() noexcept {
+        return exec::when_any(
+                uvexec::every(stdexec::schedule(loop.get_scheduler()), 1ms, [&](std::size_t) noexcept {
+                    ++ticks;
+                    return true;
+                }) | stdexec::then([] { return false; }),
+                exec::schedule_after(loop.get_scheduler(), 20ms) | stdexec::then([] { return true; }));
+    })).value();
+
+    REQUIRE(stopped);
+    REQUIRE(ticks > 0);
+    REQUIRE(ticks <= 20);
+}
+
+TEST_CASE("With timeout", "[loop][timer]") {
+    TLoop loop;
+
+    auto [value] = stdexec::sync_wait(uvexec::with_timeout(exec::schedule_after(loop.get_scheduler(), 1ms)
+            | stdexec::then([] {
+                return 42;
+            }), 1h)).value();
+    REQUIRE(value == 42);
+
+    auto start = exec::now(loop.get_scheduler());
+    try {
+        stdexec::sync_wait(exec::schedule_after(loop.get_scheduler(), 1h) | uvexec::with_timeout(5ms));
+        FAIL("Timeout hasn't fired");
+    } catch (const std::system_error& e) {
+        REQUIRE(e.code() == EErrc::timed_out);
+    }
+    REQUIRE(start + 5ms <= exec::now(loop.get_scheduler()));
+}
+
+TEST_CASE("With timeout stopped from outside", "[loop][timer]") {
+    TLoop loop;
+
+    auto [timedOut] = stdexec::sync_wait(stdexec::schedule(loop.get_scheduler()) | stdexec::let_value([&]() noexcept {
+        return exec::when_any(
+                uvexec::with_timeout(exec::schedule_after(loop.get_scheduler(), 1h), 1h)
+                        | stdexec::then([] { return true; }),
+                exec::schedule_after(loop.get_scheduler(), 1ms) | stdexec::then([] { return false; }));
+    })).value();
+
+    REQUIRE_FALSE(timedOut);
+}
+
+TEST_CASE("With timeout stopped from another thread before the timer fires", "[loop][timer][mt]") {
+    TLoop loop;
+    std::atomic<TManualStopSender::TStopper*> started{nullptr};
+    std::latch deadlinePassed{1};
+    std::latch stopped{1};
+
+    std::thread stopper([&] {
+        deadlinePassed.wait();
+        started.load()->Stop();
+        stopped.count_down();
+    });
+    // The completion is handed over to the loop while it's blocked past the deadline, so the timer fires before
+    // the handed over completion is applied, it's still the completion that wins
+    auto result = stdexec::sync_wait(stdexec::schedule(loop.get_scheduler()) | stdexec::let_value([&]() noexcept {
+        return stdexec::when_all(
+                uvexec::with_timeout(TManualStopSender(started), 10ms),
+                stdexec::schedule(loop.get_scheduler()) | stdexec::then([&]() noexcept {
+                    std::this_thread::sleep_for(50ms);
+                    deadlinePassed.count_down();
+                    stopped.wait();
+                }));
+    }));
+    stopper.join();
+
+    REQUIRE_FALSE(result.has_value());
+}
+
+TEST_CASE("With timeout of inline stopped sender", "[loop][timer]") {
+    TLoop loop;
+
+    try {
+        stdexec::sync_wait(uvexec::with_timeout(TStoppedOnRequestSender(loop), 1ms));
+        FAIL("Timeout hasn't fired");
+    } catch (const std::system_error& e) {
+        REQUIRE(e.code() == EErrc::timed_out);
+    }
+
+    auto [timedOut] = stdexec::sync_wait(stdexec::schedule(loop.get_scheduler()) | stdexec::let_value([&]() noexcept {
+        return exec::when_any(
+                uvexec::with_timeout(TStoppedOnRequestSender(loop), 1h) | stdexec::then([] { return true; }),
+                exec::schedule_after(loop.get_scheduler(), 1ms) | stdexec::then([] { return false; }));
+    })).value();
+    REQUIRE_FALSE(timedOut);
+}